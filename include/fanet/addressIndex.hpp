@@ -0,0 +1,123 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "address.hpp"
+
+namespace FANET
+{
+    /**
+     * @brief Hash index from an address to a slot of a table, open addressing with linear probing.
+     *
+     * The index only stores slots, the table provides the address of a slot to the lookup, so an entry costs
+     * two to four times the size of a slot. Removal moves the following entries back, there are no tombstones.
+     *
+     * @tparam CAPACITY Maximum number of slots in the table.
+     * @tparam Slot Unsigned type of a slot number, its maximum value marks an empty position.
+     */
+    template <size_t CAPACITY, typename Slot>
+    class AddressIndex
+    {
+        static constexpr size_t indexSize()
+        {
+            size_t size = 1;
+            while (size < 2 * CAPACITY)
+            {
+                size <<= 1;
+            }
+            return size;
+        }
+
+        static constexpr size_t bits()
+        {
+            size_t bits = 0;
+            while ((size_t(1) << bits) < indexSize())
+            {
+                bits++;
+            }
+            return bits;
+        }
+
+        static constexpr size_t SIZE = indexSize();
+        static constexpr size_t MASK = SIZE - 1;
+        static constexpr size_t BITS = bits();
+
+        Slot index_[SIZE];
+
+        static size_t home(const Address &address)
+        {
+            // Fibonacci hashing, the top bits of the product are mixed best
+            return static_cast<uint32_t>(address.asUint() * 2654435769u) >> (32 - BITS);
+        }
+
+    public:
+        static constexpr Slot EMPTY = static_cast<Slot>(~static_cast<Slot>(0));
+        static_assert(CAPACITY < EMPTY, "Slot type too small for CAPACITY");
+
+        AddressIndex()
+        {
+            clear();
+        }
+
+        void clear()
+        {
+            for (auto &i : index_)
+            {
+                i = EMPTY;
+            }
+        }
+
+        /**
+         * @brief Find the position of an address, or the empty position where it would go.
+         * @param address The address.
+         * @param addressOf Returns the address of a slot.
+         */
+        template <typename AddressOf>
+        size_t position(const Address &address, AddressOf addressOf) const
+        {
+            auto pos = home(address);
+            while (index_[pos] != EMPTY && addressOf(index_[pos]) != address)
+            {
+                pos = (pos + 1) & MASK;
+            }
+            return pos;
+        }
+
+        Slot &operator[](size_t pos)
+        {
+            return index_[pos];
+        }
+
+        Slot operator[](size_t pos) const
+        {
+            return index_[pos];
+        }
+
+        /**
+         * @brief Remove a position and move the following entries back in its place.
+         * @param pos The position, as returned by position().
+         * @param addressOf Returns the address of a slot.
+         */
+        template <typename AddressOf>
+        void unlink(size_t pos, AddressOf addressOf)
+        {
+            auto next = pos;
+            while (true)
+            {
+                next = (next + 1) & MASK;
+                if (index_[next] == EMPTY)
+                {
+                    break;
+                }
+                // Move the entry back unless its home lies cyclically in (pos, next]
+                auto h = home(addressOf(index_[next]));
+                if (((next - h) & MASK) >= ((next - pos) & MASK))
+                {
+                    index_[pos] = index_[next];
+                    pos = next;
+                }
+            }
+            index_[pos] = EMPTY;
+        }
+    };
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <stdint.h>
+#include "etl/array.h"
+
+#include "header.hpp"
+#include "packet.hpp"
+
+namespace FANET
+{
+    static constexpr size_t FANET_BEACON_MAXFRAMESIZE = 32;
+
+    /**
+     * @brief Beacons that are send periodically by the protocol once a provider is registered.
+     */
+    enum class BeaconType : uint8_t
+    {
+        TRACKING = 0, // Tracking or ground tracking, every floor((#neighbors/10 + 1) * 5s)
+        NAME = 1,     // Name, every 4min
+        SERVICE = 2,  // Service, every 40sec
+    };
+
+    static constexpr size_t BEACON_TYPE_COUNT = 3;
+
+    /**
+     * @brief Interface for the application to provide the content of a beacon when it is due.
+     */
+    class BeaconProvider
+    {
+    public:
+        virtual ~BeaconProvider() {}
+
+        /**
+         * @brief Called when a beacon is due.
+         * Set the payload of the packet, eg a TrackingPayload or GroundTrackingPayload for BeaconType::TRACKING.
+         * Source and forwarding are handled by the protocol.
+         * @param type The beacon that is due.
+         * @param packet The packet to fill.
+         * @return false when nothing should be send this time, eg when there is no GPS fix
+         */
+        virtual bool fanet_beacon(BeaconType type, Packet<FANET_BEACON_MAXFRAMESIZE> &packet) = 0;
+    };
+
+    /**
+     * @brief Keeps track of when each registered beacon is due.
+     *
+     * The tracking interval grows with the number of neighbors as recommended in protocol.txt,
+     * names and services use a fixed interval.
+     */
+    class BeaconScheduler
+    {
+    public:
+        static constexpr uint32_t TRACKING_TAU_MS = 5000; // Also Protocol::APP_TYPE1OR7_TAU_MS
+        static constexpr uint32_t NAME_INTERVAL_MS = 4 * 60 * 1000;
+        static constexpr uint32_t SERVICE_INTERVAL_MS = 40 * 1000;
+
+    private:
+        struct Beacon
+        {
+            BeaconProvider *provider = nullptr;
+            uint32_t nextTx = 0;
+        };
+        etl::array<Beacon, BEACON_TYPE_COUNT> beacons;
+
+        Beacon &beacon(BeaconType type)
+        {
+            return beacons[static_cast<uint8_t>(type)];
+        }
+
+        const Beacon &beacon(BeaconType type) const
+        {
+            return beacons[static_cast<uint8_t>(type)];
+        }
+
+    public:
+        /**
+         * @brief Get the recommended interval of a beacon.
+         * @param type The beacon.
+         * @param neighbors Number of neighbors in the neighbor table.
+         * @return The interval in ms.
+         */
+        static uint32_t interval(BeaconType type, size_t neighbors)
+        {
+            switch (type)
+            {
+            case BeaconType::TRACKING:
+                return (neighbors / 10 + 1) * TRACKING_TAU_MS;
+            case BeaconType::NAME:
+                return NAME_INTERVAL_MS;
+            case BeaconType::SERVICE:
+                return SERVICE_INTERVAL_MS;
+            }
+            return NAME_INTERVAL_MS;
+        }
+
+        void clear()
+        {
+            beacons = {};
+        }
+
+        /**
+         * @brief Register a provider, the first beacon is due immediately.
+         * @param type The beacon.
+         * @param provider The provider, nullptr stops the beacon.
+         * @param timeMs Current time.
+         */
+        void provider(BeaconType type, BeaconProvider *provider, uint32_t timeMs)
+        {
+            beacon(type) = Beacon{provider, timeMs};
+        }
+
+        BeaconProvider *provider(BeaconType type) const
+        {
+            return beacon(type).provider;
+        }
+
+        /**
+         * @brief Check if a registered beacon is due.
+         */
+        bool due(BeaconType type, uint32_t timeMs) const
+        {
+            auto &b = beacon(type);
+            return b.provider != nullptr && static_cast<int32_t>(timeMs - b.nextTx) >= 0;
+        }
+
+        /**
+         * @brief Schedule the next beacon one interval after timeMs.
+         */
+        void sent(BeaconType type, uint32_t timeMs, size_t neighbors)
+        {
+            beacon(type).nextTx = timeMs + interval(type, neighbors);
+        }
+
+        /**
+         * @brief Move the beacon to a later time without sending it.
+         */
+        void postpone(BeaconType type, uint32_t nextTx)
+        {
+            beacon(type).nextTx = nextTx;
+        }
+
+        uint32_t nextTx(BeaconType type) const
+        {
+            return beacon(type).nextTx;
+        }
+
+        /**
+         * @brief Get the time the first registered beacon is due.
+         * @param timeMs Current time.
+         * @param defaultTime Returned when no beacon is registered.
+         */
+        uint32_t nextTx(uint32_t timeMs, uint32_t defaultTime) const
+        {
+            auto next = defaultTime;
+            for (const auto &b : beacons)
+            {
+                if (b.provider != nullptr && static_cast<int32_t>(b.nextTx - timeMs) < static_cast<int32_t>(next - timeMs))
+                {
+                    next = b.nextTx;
+                }
+            }
+            return next;
+        }
+    };
+}
@@ -28,6 +28,47 @@ private:
     using BLOCK_STORE = etl::vector<T, MAX_BLOCKS>;
     BLOCK_STORE allocatedBlocks;               // Stores allocated objects
 
+    /**
+     * @brief Find the first free contiguous blocks.
+     * @param blocksNeeded Number of blocks.
+     * @param released Object whose blocks count as free, e.g. when it is removed for the new one.
+     * @return The index of the first block, or MAX_BLOCKS when there is no room.
+     */
+    size_t findFree(size_t blocksNeeded, typename BLOCK_STORE::const_iterator released = nullptr) const
+    {
+        size_t releasedFirst = MAX_BLOCKS;
+        size_t releasedEnd = MAX_BLOCKS;
+        if (released != nullptr)
+        {
+            releasedFirst = (released->data().data() - memoryPool.data()) / BLOCK_SIZE;
+            releasedEnd = releasedFirst + (released->data().size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        }
+
+        if (blocksNeeded > MAX_BLOCKS || (allocatedBlocks.full() && released == nullptr))
+        {
+            return MAX_BLOCKS;
+        }
+
+        for (size_t i = 0; i <= MAX_BLOCKS - blocksNeeded; ++i)
+        {
+            bool found = true;
+            for (size_t j = 0; j < blocksNeeded; ++j)
+            {
+                if (allocationMap[i + j] && (i + j < releasedFirst || i + j >= releasedEnd))
+                {
+                    found = false;
+                    break;
+                }
+            }
+
+            if (found)
+            {
+                return i;
+            }
+        }
+        return MAX_BLOCKS; // No free contiguous blocks
+    }
+
 public:
     /**
      * @brief Constructor that initializes the block allocator.
@@ -58,37 +99,70 @@ public:
         size_t size = data.data().size();
         size_t blocksNeeded = (size + BLOCK_SIZE - 1) / BLOCK_SIZE; // Round up to nearest block
 
-        for (size_t i = 0; i <= MAX_BLOCKS - blocksNeeded; ++i)
+        size_t i = findFree(blocksNeeded);
+        if (i == MAX_BLOCKS)
         {
-            bool found = true;
-            for (size_t j = 0; j < blocksNeeded; ++j)
-            {
-                if (allocationMap[i + j])
-                {
-                    found = false;
-                    break;
-                }
-            }
+            return false; // No free contiguous blocks
+        }
 
-            if (found)
-            {
-                for (size_t j = 0; j < blocksNeeded; ++j)
-                {
-                    allocationMap.set(i + j);
-                }
+        for (size_t j = 0; j < blocksNeeded; ++j)
+        {
+            allocationMap.set(i + j);
+        }
 
-                uint8_t *memStart = memoryPool.data() + (i * BLOCK_SIZE);
-                etl::span<uint8_t> newSpan(memStart, size);
-                std::copy(data.data().begin(), data.data().end(), memStart);
-                
-                // Update data to reference its new memory location
-                T newBlock = data;
-                newBlock.data(newSpan);
-                allocatedBlocks.push_back(newBlock);
-                return true;
-            }
+        uint8_t *memStart = memoryPool.data() + (i * BLOCK_SIZE);
+        etl::span<uint8_t> newSpan(memStart, size);
+        std::copy(data.data().begin(), data.data().end(), memStart);
+
+        // Update data to reference its new memory location
+        T newBlock = data;
+        newBlock.data(newSpan);
+        allocatedBlocks.push_back(newBlock);
+        return true;
+    }
+
+    /**
+     * @brief Check if an object of the given size can be added.
+     *
+     * @param size Size of the data in bytes.
+     * @return True if there are enough free contiguous blocks.
+     */
+    bool canAdd(size_t size) const
+    {
+        return findFree((size + BLOCK_SIZE - 1) / BLOCK_SIZE) != MAX_BLOCKS;
+    }
+
+    /**
+     * @brief Check if an object of the given size can be added once another object is removed.
+     *
+     * @param size Size of the data in bytes.
+     * @param released The object that is removed first.
+     * @return True if there are enough free contiguous blocks with the blocks of released.
+     */
+    bool canAdd(size_t size, typename BLOCK_STORE::const_iterator released) const
+    {
+        return findFree((size + BLOCK_SIZE - 1) / BLOCK_SIZE, released) != MAX_BLOCKS;
+    }
+
+    /**
+     * @brief Overwrites the data of an object in place.
+     *
+     * @param it The object to update.
+     * @param data The new data, it must need the same number of blocks as the current data.
+     * @return True if the data was replaced, false when the number of blocks differs.
+     */
+    bool replace(typename BLOCK_STORE::iterator it, etl::span<const uint8_t> data)
+    {
+        size_t blocks = (it->data().size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        if (data.size() == 0 || (data.size() + BLOCK_SIZE - 1) / BLOCK_SIZE != blocks)
+        {
+            return false;
         }
-        return false; // No free contiguous blocks
+
+        uint8_t *memStart = it->data().data();
+        std::copy(data.begin(), data.end(), memStart);
+        it->data(etl::span<uint8_t>(memStart, data.size()));
+        return true;
     }
 
     /**
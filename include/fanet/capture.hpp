@@ -0,0 +1,260 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <iterator>
+#include "etl/span.h"
+
+#include "protocol.hpp"
+#include "rxQueue.hpp"
+
+namespace FANET
+{
+    /**
+     * Capture of FANET traffic, little endian:
+     * - File header: "FNCP", version, 3 reserved bytes
+     * - Records appended one after the other: time (4 bytes), rssi (2), coding rate (1), interface (1), flags (1),
+     *   frame length (1) and the raw frame
+     * A record that was cut off at the end, e.g. by a power loss while writing, is ignored by the reader.
+     */
+    static constexpr uint8_t CAPTURE_MAGIC[4] = {'F', 'N', 'C', 'P'};
+    static constexpr uint8_t CAPTURE_VERSION = 1;
+    static constexpr size_t CAPTURE_HEADER_SIZE = 8;
+    static constexpr size_t CAPTURE_RECORD_HEADER_SIZE = 10;
+    static constexpr uint8_t CAPTURE_FLAG_TRANSMITTED = 0x01;
+
+    /**
+     * @brief A frame of a capture, the frame points into the capture.
+     */
+    struct CaptureRecord
+    {
+        uint32_t timeMs;   // Tick when the frame was received or send
+        int16_t rssi;      // Rssi in dBm, 0 for transmitted frames
+        uint8_t codingRate;
+        uint8_t interface; // Index of the radio
+        uint8_t flags;
+        etl::span<const uint8_t> frame;
+
+        /**
+         * @brief Check if the frame was send by the recording device.
+         */
+        bool transmitted() const
+        {
+            return flags & CAPTURE_FLAG_TRANSMITTED;
+        }
+    };
+
+    /**
+     * @brief Appends frames to a capture.
+     *
+     * Each record is written with a single write to the sink, the file header before the first record.
+     *
+     * @tparam Sink Provides size_t write(const uint8_t *data, size_t size), returning the bytes written,
+     * e.g. an Arduino File or StdioSink.
+     */
+    template <typename Sink>
+    class CaptureWriter
+    {
+        Sink &sink_;
+        bool headerWritten_;
+        uint32_t records_ = 0;
+
+        bool write(const CaptureRecord &record)
+        {
+            if (!headerWritten_)
+            {
+                uint8_t header[CAPTURE_HEADER_SIZE] = {CAPTURE_MAGIC[0], CAPTURE_MAGIC[1], CAPTURE_MAGIC[2], CAPTURE_MAGIC[3], CAPTURE_VERSION, 0, 0, 0};
+                if (sink_.write(header, sizeof(header)) != sizeof(header))
+                {
+                    return false;
+                }
+                headerWritten_ = true;
+            }
+
+            size_t length = record.frame.size() > 0xFF ? 0xFF : record.frame.size();
+            uint8_t buffer[CAPTURE_RECORD_HEADER_SIZE + 0xFF];
+            buffer[0] = record.timeMs & 0xFF;
+            buffer[1] = (record.timeMs >> 8) & 0xFF;
+            buffer[2] = (record.timeMs >> 16) & 0xFF;
+            buffer[3] = record.timeMs >> 24;
+            buffer[4] = static_cast<uint16_t>(record.rssi) & 0xFF;
+            buffer[5] = static_cast<uint16_t>(record.rssi) >> 8;
+            buffer[6] = record.codingRate;
+            buffer[7] = record.interface;
+            buffer[8] = record.flags;
+            buffer[9] = static_cast<uint8_t>(length);
+            memcpy(&buffer[CAPTURE_RECORD_HEADER_SIZE], record.frame.data(), length);
+
+            size_t size = CAPTURE_RECORD_HEADER_SIZE + length;
+            if (sink_.write(buffer, size) != size)
+            {
+                return false;
+            }
+            records_++;
+            return true;
+        }
+
+    public:
+        /**
+         * @param sink Where the capture is written to.
+         * @param append True when the sink already contains a capture, the file header is not written again.
+         */
+        CaptureWriter(Sink &sink, bool append = false) : sink_(sink), headerWritten_(append) {}
+
+        /**
+         * @brief Append a received frame, e.g. from the radio before Protocol::handleRx.
+         * @return false when the sink did not take the whole record.
+         */
+        bool received(uint32_t timeMs, int16_t rssi, uint8_t codingRate, etl::span<const uint8_t> frame, uint8_t interface = 0)
+        {
+            return write(CaptureRecord{timeMs, rssi, codingRate, interface, 0, frame});
+        }
+
+        /**
+         * @brief Append a frame of the receive queue.
+         */
+        bool received(const RxFrame &frame, uint8_t codingRate)
+        {
+            return received(frame.timeMs, frame.rssi, codingRate, frame.frame(), frame.interface);
+        }
+
+        /**
+         * @brief Append a frame send by this device, e.g. from Connector::fanet_sendFrame.
+         */
+        bool transmitted(uint32_t timeMs, uint8_t codingRate, etl::span<const uint8_t> frame, uint8_t interface = 0)
+        {
+            return write(CaptureRecord{timeMs, 0, codingRate, interface, CAPTURE_FLAG_TRANSMITTED, frame});
+        }
+
+        /**
+         * @brief Number of records written by this writer.
+         */
+        uint32_t records() const
+        {
+            return records_;
+        }
+    };
+
+    /**
+     * @brief Reads the records of a capture in memory, without copying the frames.
+     */
+    class CaptureReader
+    {
+        etl::span<const uint8_t> data_;
+
+    public:
+        class iterator
+        {
+            etl::span<const uint8_t> rest_;
+            CaptureRecord record_;
+
+            void parse()
+            {
+                if (rest_.size() < CAPTURE_RECORD_HEADER_SIZE || rest_.size() < CAPTURE_RECORD_HEADER_SIZE + rest_[9])
+                {
+                    rest_ = etl::span<const uint8_t>();
+                    return;
+                }
+                record_.timeMs = rest_[0] | (rest_[1] << 8) | (rest_[2] << 16) | (static_cast<uint32_t>(rest_[3]) << 24);
+                record_.rssi = static_cast<int16_t>(rest_[4] | (rest_[5] << 8));
+                record_.codingRate = rest_[6];
+                record_.interface = rest_[7];
+                record_.flags = rest_[8];
+                record_.frame = rest_.subspan(CAPTURE_RECORD_HEADER_SIZE, rest_[9]);
+            }
+
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = CaptureRecord;
+            using difference_type = ptrdiff_t;
+            using pointer = const CaptureRecord *;
+            using reference = const CaptureRecord &;
+
+            explicit iterator(etl::span<const uint8_t> rest) : rest_(rest), record_{}
+            {
+                parse();
+            }
+
+            const CaptureRecord &operator*() const
+            {
+                return record_;
+            }
+
+            const CaptureRecord *operator->() const
+            {
+                return &record_;
+            }
+
+            iterator &operator++()
+            {
+                rest_ = rest_.subspan(CAPTURE_RECORD_HEADER_SIZE + record_.frame.size());
+                parse();
+                return *this;
+            }
+
+            bool operator==(const iterator &other) const
+            {
+                return rest_.data() == other.rest_.data() && rest_.size() == other.rest_.size();
+            }
+
+            bool operator!=(const iterator &other) const
+            {
+                return !(*this == other);
+            }
+        };
+
+        /**
+         * @param data The whole capture, including the file header.
+         */
+        explicit CaptureReader(etl::span<const uint8_t> data) : data_(data) {}
+
+        /**
+         * @brief Check the file header.
+         */
+        bool valid() const
+        {
+            return data_.size() >= CAPTURE_HEADER_SIZE && memcmp(data_.data(), CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) == 0 &&
+                   data_[4] == CAPTURE_VERSION;
+        }
+
+        iterator begin() const
+        {
+            return iterator(valid() ? data_.subspan(CAPTURE_HEADER_SIZE) : etl::span<const uint8_t>());
+        }
+
+        iterator end() const
+        {
+            return iterator(etl::span<const uint8_t>());
+        }
+    };
+
+    /**
+     * @brief Feed the received frames of a capture to the protocol on the time of the capture, as fast as possible.
+     *
+     * Frames send by the recording device are skipped. The protocol reads the time from Connector::fanet_getTick
+     * in a few places, e.g. to schedule forwards and acks, so step is called with the time of every record before it is
+     * handled. Let the connector of the protocol return that time, and call Protocol::handleTx from step to let the
+     * transmit side follow the capture.
+     *
+     * @param protocol The protocol to feed.
+     * @param capture The capture.
+     * @param step Called with the time of each record, also for skipped records.
+     * @return Number of frames handled.
+     */
+    template <typename Step>
+    size_t replay(Protocol &protocol, const CaptureReader &capture, Step step)
+    {
+        size_t frames = 0;
+        for (const auto &record : capture)
+        {
+            step(record.timeMs);
+            if (record.transmitted())
+            {
+                continue;
+            }
+            protocol.handleRx(record.rssi, record.frame, record.timeMs, record.interface);
+            frames++;
+        }
+        return frames;
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "etl/span.h"
+
+#include "capture.hpp"
+
+/**
+ * Capture files on a host, Linux and other POSIX systems. Not used by the protocol.
+ */
+namespace FANET
+{
+    /**
+     * @brief Sink of a CaptureWriter that writes to a stdio file.
+     */
+    class StdioSink
+    {
+        FILE *file_;
+
+    public:
+        explicit StdioSink(FILE *file) : file_(file) {}
+
+        size_t write(const uint8_t *data, size_t size)
+        {
+            return fwrite(data, 1, size, file_);
+        }
+
+        void flush()
+        {
+            fflush(file_);
+        }
+    };
+
+    /**
+     * @brief A capture file mapped into memory, read it with CaptureReader(mapped.data()).
+     *
+     * The file is mapped read only and the frames of the records point into the mapping, nothing is copied.
+     * A capture that is still being written can be mapped, records appended after open() are not seen.
+     */
+    class MappedCapture
+    {
+        const uint8_t *data_ = nullptr;
+        size_t size_ = 0;
+
+    public:
+        MappedCapture() = default;
+        MappedCapture(const MappedCapture &) = delete;
+        MappedCapture &operator=(const MappedCapture &) = delete;
+
+        ~MappedCapture()
+        {
+            close();
+        }
+
+        /**
+         * @brief Map a capture file.
+         * @return false when the file can not be opened or mapped.
+         */
+        bool open(const char *path)
+        {
+            close();
+            int fd = ::open(path, O_RDONLY);
+            if (fd < 0)
+            {
+                return false;
+            }
+
+            struct stat st;
+            bool ok = fstat(fd, &st) == 0 && st.st_size > 0;
+            if (ok)
+            {
+                void *mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                ok = mapping != MAP_FAILED;
+                if (ok)
+                {
+                    madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+                    data_ = static_cast<const uint8_t *>(mapping);
+                    size_ = st.st_size;
+                }
+            }
+            ::close(fd);
+            return ok;
+        }
+
+        void close()
+        {
+            if (data_ != nullptr)
+            {
+                munmap(const_cast<uint8_t *>(data_), size_);
+                data_ = nullptr;
+                size_ = 0;
+            }
+        }
+
+        etl::span<const uint8_t> data() const
+        {
+            return etl::span<const uint8_t>(data_, size_);
+        }
+    };
+}
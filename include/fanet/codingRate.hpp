@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "address.hpp"
+#include "neighbourTable.hpp"
+
+namespace FANET
+{
+    /**
+     * @brief Everything known about a frame when its coding rate is chosen.
+     * Coding rates are given as 5 (4/5) up to 8 (4/8), as passed to fanet_sendFrame.
+     */
+    struct CodingRateRequest
+    {
+        Address destination;         // Address{} for broadcasts
+        int16_t rssi;                // Average rssi of the destination, NEIGHBOR_RSSI_UNKNOWN for broadcasts and unknown neighbors
+        uint16_t lengthBytes;        // Length of the frame
+        size_t neighbors;            // Number of neighbors in the neighbor table
+        uint32_t remainingAirtimeMs; // Airtime left before the duty cycle limit is reached
+        uint8_t defaultCodingRate;   // Coding rate based on the number of neighbors only
+    };
+
+    /**
+     * @brief Interface to decide the coding rate of each frame that is sent.
+     */
+    class CodingRatePolicy
+    {
+    public:
+        virtual ~CodingRatePolicy() {}
+
+        /**
+         * @brief Choose the coding rate of a frame.
+         * @return The coding rate, 5 (4/5) up to 8 (4/8).
+         */
+        virtual uint8_t codingRate(const CodingRateRequest &request) = 0;
+    };
+
+    /**
+     * @brief Coding rate policy that uses the link quality to the destination and the airtime budget.
+     *
+     * Short unicast frames to a strong neighbor use 4/5, unicast frames to a weak or unknown neighbor use 4/8.
+     * When the airtime budget is almost used, all frames that are not send over a weak link use 4/5.
+     * Everything else uses the default coding rate based on the number of neighbors.
+     */
+    class LinkAdaptiveCodingRatePolicy : public CodingRatePolicy
+    {
+        int16_t strongRssiDbm;
+        int16_t weakRssiDbm;
+        uint16_t maxShortLength;
+        uint32_t lowBudgetMs;
+
+    public:
+        /**
+         * @param strongRssiDbm Neighbors received at or above this rssi have a strong link.
+         * @param weakRssiDbm Neighbors received below this rssi have a weak link.
+         * @param maxShortLength Frames up to this length are short.
+         * @param lowBudgetMs Below this remaining airtime the budget is almost used.
+         */
+        LinkAdaptiveCodingRatePolicy(int16_t strongRssiDbm = -90, int16_t weakRssiDbm = -110, uint16_t maxShortLength = 32, uint32_t lowBudgetMs = 3000)
+            : strongRssiDbm(strongRssiDbm), weakRssiDbm(weakRssiDbm), maxShortLength(maxShortLength), lowBudgetMs(lowBudgetMs) {}
+
+        uint8_t codingRate(const CodingRateRequest &request) override
+        {
+            bool unicast = request.destination != Address{};
+            if (unicast && request.rssi >= strongRssiDbm && request.lengthBytes <= maxShortLength)
+            {
+                return 5;
+            }
+            if (unicast && request.rssi < weakRssiDbm)
+            {
+                return 8;
+            }
+            if (request.remainingAirtimeMs < lowBudgetMs)
+            {
+                return 5;
+            }
+            return request.defaultCodingRate;
+        }
+    };
+}
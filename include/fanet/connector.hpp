@@ -5,6 +5,21 @@
 
 namespace FANET
 {
+    class PacketView;
+
+    /**
+     * @brief Progress of a packet send by the application, see Connector::fanet_txStatus.
+     */
+    enum class TxStatus : uint8_t
+    {
+        QUEUED,        // Added to the transmit pool
+        TRANSMITTED,   // Send for the first time, packets without ack are removed from the pool
+        RETRANSMITTED, // Send again because no ack was received yet
+        ACKED,         // Ack received, removed from the pool
+        TIMED_OUT,     // No ack received after all retransmissions, removed from the pool
+        REJECTED,      // Not added to the transmit pool, the reason is returned by sendPacket
+        DROPPED,       // Removed without being send, eg the radio failed to send a tracking packet
+    };
 
     class Connector
     {
@@ -30,6 +45,42 @@ namespace FANET
          * @param id the id of the ack
          */
         virtual void fanet_ackReceived(uint16_t id) = 0;
+
+        /**
+         * @brief Listen before talk, called right before a frame is sent.
+         * Implement this with channel activity detection (CAD) or an rssi reading of the radio.
+         * When busy the protocol backs off a random time before trying again.
+         * @return true when the channel is busy
+         */
+        virtual bool fanet_channelBusy()
+        {
+            return false;
+        }
+
+        /**
+         * @brief Optional, called for every frame that is broadcast or addressed to us, so the application does not
+         * need to parse the frame again. Frames send by ourselves, frames received by more than one radio and
+         * retransmissions of frames already queued for forwarding are not reported.
+         * @param packet The received frame, only valid during the call
+         * @param rssi the rssi of the frame in dBm
+         */
+        virtual void fanet_packetReceived(const PacketView &packet, int16_t rssi)
+        {
+            (void)packet;
+            (void)rssi;
+        }
+
+        /**
+         * @brief Optional, called when a packet send by the application changes state,
+         * eg to implement backpressure or retries in the application.
+         * @param id the id given to sendPacket
+         * @param status the new state of the packet
+         */
+        virtual void fanet_txStatus(uint16_t id, TxStatus status)
+        {
+            (void)id;
+            (void)status;
+        }
     };
 
 }
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <stdint.h>
+#include "etl/circular_buffer.h"
+
+namespace FANET
+{
+    /**
+     * @brief Duty cycle limits of a region.
+     * Limits are given in per mille of the window, eg 900 allows 27s of airtime in a window of 30s.
+     */
+    struct DutyCycleLimits
+    {
+        uint32_t windowMs = 30000;      // Length of the sliding window
+        uint16_t txPermille = 900;      // No frames are sent once this is reached, except for own tracking
+        uint16_t forwardPermille = 500; // Received frames are not forwarded once this is reached
+    };
+
+    /**
+     * @brief Sliding window duty cycle meter.
+     *
+     * Every transmission is stored with its start time in a ring buffer and counts for its full airtime until it leaves
+     * the window. Expired records are removed from the front while adding or querying, so updates are amortised O(1).
+     * When the ring buffer is full the oldest record moves to an overflow bucket that collects the records of one
+     * slot of window / (OVERFLOW_SLOTS - 1) and expires with its newest record. The meter is exact while the ring
+     * buffer holds all transmissions of the window, above that airtime is counted at most one slot too long, never
+     * too short.
+     *
+     * @tparam MAX_RECORDS Maximum number of transmissions kept exactly in the window.
+     */
+    template <size_t MAX_RECORDS>
+    class DutyCycle
+    {
+        static constexpr size_t OVERFLOW_SLOTS = 16;
+
+        struct Record
+        {
+            uint32_t timeMs;
+            uint32_t airtimeMs;
+        };
+
+        struct Bucket
+        {
+            uint32_t startMs; // Time of the first record in the bucket
+            uint32_t timeMs;  // Time of the newest record in the bucket, the bucket expires with it
+            uint32_t airtimeMs;
+        };
+
+        etl::circular_buffer<Bucket, OVERFLOW_SLOTS> overflow;
+        etl::circular_buffer<Record, MAX_RECORDS> records;
+        uint32_t totalAirtime = 0;
+        uint32_t windowMs;
+
+        static int32_t elapsed(uint32_t currentTimeMs, uint32_t timeMs)
+        {
+            return static_cast<int32_t>(currentTimeMs - timeMs);
+        }
+
+        /**
+         * @brief Remove the records that left the window.
+         * Records newer than currentTimeMs are kept, e.g. when a frame received earlier is handled after a transmission.
+         */
+        void expire(uint32_t currentTimeMs)
+        {
+            while (!overflow.empty() && elapsed(currentTimeMs, overflow.front().timeMs) >= static_cast<int32_t>(windowMs))
+            {
+                totalAirtime -= overflow.front().airtimeMs;
+                overflow.pop();
+            }
+            while (!records.empty() && elapsed(currentTimeMs, records.front().timeMs) >= static_cast<int32_t>(windowMs))
+            {
+                totalAirtime -= records.front().airtimeMs;
+                records.pop();
+            }
+        }
+
+        /**
+         * @brief Move the oldest record into the overflow buckets.
+         * Buckets start at least one slot apart, so with window / (OVERFLOW_SLOTS - 1) per slot the oldest bucket has
+         * expired before all buckets are in use.
+         */
+        void spill()
+        {
+            auto oldest = records.front();
+            records.pop();
+
+            uint32_t slotMs = (windowMs + OVERFLOW_SLOTS - 2) / (OVERFLOW_SLOTS - 1);
+            // All buckets can only be in use after the window grew, the newest bucket then spans more than a slot
+            if (!overflow.empty() && ((oldest.timeMs - overflow.back().startMs) < slotMs || overflow.full()))
+            {
+                overflow.back().timeMs = oldest.timeMs;
+                overflow.back().airtimeMs += oldest.airtimeMs;
+                return;
+            }
+            overflow.push(Bucket{oldest.timeMs, oldest.timeMs, oldest.airtimeMs});
+        }
+
+        uint32_t budget(uint16_t limitPermille) const
+        {
+            return (static_cast<uint64_t>(windowMs) * limitPermille) / 1000;
+        }
+
+    public:
+        explicit DutyCycle(uint32_t windowMs = 30000) : windowMs(windowMs) {}
+
+        /**
+         * @brief Change the length of the sliding window, records that fall outside the new window are removed on the next update.
+         */
+        void window(uint32_t newWindowMs)
+        {
+            windowMs = newWindowMs;
+        }
+
+        uint32_t window() const
+        {
+            return windowMs;
+        }
+
+        void clear()
+        {
+            overflow.clear();
+            records.clear();
+            totalAirtime = 0;
+        }
+
+        /**
+         * @brief Register a transmission.
+         * @param currentTimeMs Start time of the transmission.
+         * @param timeOnAirMs Airtime of the transmission.
+         */
+        void set(uint32_t currentTimeMs, uint16_t timeOnAirMs)
+        {
+            expire(currentTimeMs);
+            if (records.full())
+            {
+                spill();
+            }
+            records.push(Record{currentTimeMs, timeOnAirMs});
+            totalAirtime += timeOnAirMs;
+        }
+
+        /**
+         * @brief Get the airtime in ms used within the window.
+         */
+        uint32_t used(uint32_t currentTimeMs)
+        {
+            expire(currentTimeMs);
+            return totalAirtime;
+        }
+
+        /**
+         * @brief Get the airtime used within the window in per mille.
+         */
+        uint32_t get(uint32_t currentTimeMs)
+        {
+            expire(currentTimeMs);
+            return getAverage();
+        }
+
+        /**
+         * @brief Get the airtime in per mille as of the last update or query.
+         */
+        uint32_t getAverage() const
+        {
+            return (static_cast<uint64_t>(totalAirtime) * 1000) / windowMs;
+        }
+
+        /**
+         * @brief Get the airtime in ms that can still be used before the limit is reached.
+         * @param currentTimeMs Current time.
+         * @param limitPermille Limit in per mille of the window.
+         */
+        uint32_t remaining(uint32_t currentTimeMs, uint16_t limitPermille)
+        {
+            expire(currentTimeMs);
+            auto allowed = budget(limitPermille);
+            return allowed > totalAirtime ? allowed - totalAirtime : 0;
+        }
+
+        /**
+         * @brief Get the time until more than timeOnAirMs of airtime is remaining.
+         * @param currentTimeMs Current time.
+         * @param limitPermille Limit in per mille of the window.
+         * @param timeOnAirMs Airtime that needs to be available.
+         * @return 0 when the airtime is available now, the window length when it never fits in the limit.
+         */
+        uint32_t timeUntil(uint32_t currentTimeMs, uint16_t limitPermille, uint16_t timeOnAirMs = 0)
+        {
+            expire(currentTimeMs);
+            auto allowed = budget(limitPermille);
+            if (timeOnAirMs >= allowed)
+            {
+                return windowMs;
+            }
+
+            auto fits = [allowed, timeOnAirMs](uint32_t used)
+            { return used < allowed && allowed - used > timeOnAirMs; };
+
+            auto used = totalAirtime;
+            if (fits(used))
+            {
+                return 0;
+            }
+            for (const auto &bucket : overflow)
+            {
+                used -= bucket.airtimeMs;
+                if (fits(used))
+                {
+                    return bucket.timeMs + windowMs - currentTimeMs;
+                }
+            }
+            for (const auto &record : records)
+            {
+                used -= record.airtimeMs;
+                if (fits(used))
+                {
+                    return record.timeMs + windowMs - currentTimeMs;
+                }
+            }
+            return windowMs;
+        }
+    };
+}
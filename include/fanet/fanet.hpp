@@ -7,6 +7,7 @@
 #include "message.hpp"
 #include "service.hpp"
 #include "groundTracking.hpp"
+#include "hwInfo.hpp"
 
 #include "ack.hpp"
 #include "address.hpp"
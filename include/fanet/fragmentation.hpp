@@ -0,0 +1,378 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "etl/algorithm.h"
+#include "etl/bitset.h"
+#include "etl/span.h"
+#include "etl/vector.h"
+
+#include "address.hpp"
+#include "message.hpp"
+#include "packet.hpp"
+#include "packetView.hpp"
+#include "protocol.hpp"
+
+namespace FANET
+{
+    /**
+     * Messages longer than one frame are split into fragments, each one a message of its own:
+     * - Sub-header 0x80 | message id (0-127)
+     * - Fragment index, fragment count, total length (big endian, 2 bytes)
+     * - The bytes of the fragment, all fragments but the last have the same length
+     */
+    static constexpr uint8_t FRAGMENT_SUBHEADER_FLAG = 0x80;
+    static constexpr size_t FRAGMENT_HEADER_SIZE = 4;
+    static constexpr uint32_t FRAGMENT_REASSEMBLY_TIMEOUT_MS = 30 * 1000;
+
+    /**
+     * @brief Sends a message as fragments and resends only the fragments that were not acknowledged.
+     *
+     * Unicast fragments request a single hop ack through the extended header, so the receiver acknowledges each
+     * fragment. An ack does not identify the frame, it removes all frames to the acknowledging address from the
+     * transmit pool, so unicast fragments are send one at a time. Broadcast fragments are send without ack while
+     * the transmit pool has room.
+     * Fragment i is send with id firstId + i, pass the fanet_txStatus callbacks to txStatus() and call send()
+     * again, e.g. from the loop, to add the next fragments and to resend lost ones.
+     *
+     * @tparam MAX_MESSAGE Maximum length of a message.
+     * @tparam FRAGMENT_SIZE Maximum bytes of the message per fragment.
+     */
+    template <size_t MAX_MESSAGE, size_t FRAGMENT_SIZE = 200>
+    class MessageFragmenter
+    {
+        static_assert(FRAGMENT_SIZE > 0 && FRAGMENT_SIZE + FRAGMENT_HEADER_SIZE <= 244, "FRAGMENT_SIZE must fit in a message payload");
+        static constexpr size_t MAX_FRAGMENTS = (MAX_MESSAGE + FRAGMENT_SIZE - 1) / FRAGMENT_SIZE;
+        static_assert(MAX_FRAGMENTS <= 255, "Too many fragments");
+        static constexpr uint8_t MAX_ATTEMPTS = 3;
+
+        enum class State : uint8_t
+        {
+            PENDING, // Not added to the transmit pool yet, or to be resend
+            QUEUED,  // In the transmit pool
+            DONE,    // Acknowledged, or transmitted for broadcasts
+            FAILED,  // Not acknowledged after MAX_ATTEMPTS
+        };
+
+        etl::vector<uint8_t, MAX_MESSAGE> message_;
+        Address destination_;
+        uint16_t firstId_ = 0;
+        uint8_t messageId_ = 0;
+        uint8_t count_ = 0;
+        uint8_t fragmentSize_ = 0;
+        State state_[MAX_FRAGMENTS] = {};
+        uint8_t attempts_[MAX_FRAGMENTS] = {};
+
+        bool unicast() const
+        {
+            return destination_ != Address{};
+        }
+
+        Packet<FRAGMENT_SIZE + FRAGMENT_HEADER_SIZE> fragment(uint8_t index) const
+        {
+            size_t offset = index * fragmentSize_;
+            size_t length = etl::min(static_cast<size_t>(fragmentSize_), message_.size() - offset);
+
+            uint8_t data[FRAGMENT_SIZE + FRAGMENT_HEADER_SIZE];
+            data[0] = index;
+            data[1] = count_;
+            data[2] = message_.size() >> 8;
+            data[3] = message_.size() & 0xFF;
+            memcpy(&data[FRAGMENT_HEADER_SIZE], &message_[offset], length);
+
+            MessagePayload<FRAGMENT_SIZE + FRAGMENT_HEADER_SIZE> payload;
+            payload.subHeader(FRAGMENT_SUBHEADER_FLAG | messageId_);
+            payload.message(etl::span<uint8_t>(data, length + FRAGMENT_HEADER_SIZE));
+
+            auto packet = Packet<FRAGMENT_SIZE + FRAGMENT_HEADER_SIZE>().payload(payload);
+            if (unicast())
+            {
+                packet.destination(destination_).singleHop();
+            }
+            return packet;
+        }
+
+    public:
+        /**
+         * @brief Start a new message, the previous one is forgotten.
+         * @param destination The destination, Address{} to broadcast without acks.
+         * @param message The message.
+         * @param messageId Id of the message, 0-127. Use a different id than the previous message to the same destination.
+         * @param firstId Packet id of the first fragment, the fragments use firstId up to firstId + fragments() - 1.
+         * @return false when the message is empty or too long.
+         */
+        bool start(const Address &destination, etl::span<const uint8_t> message, uint8_t messageId, uint16_t firstId)
+        {
+            count_ = 0;
+            if (message.empty() || message.size() > MAX_MESSAGE)
+            {
+                return false;
+            }
+
+            message_.assign(message.begin(), message.end());
+            destination_ = destination;
+            messageId_ = messageId & 0x7F;
+            firstId_ = firstId;
+            count_ = (message.size() + FRAGMENT_SIZE - 1) / FRAGMENT_SIZE;
+            fragmentSize_ = (message.size() + count_ - 1) / count_;
+            for (uint8_t i = 0; i < count_; i++)
+            {
+                state_[i] = State::PENDING;
+                attempts_[i] = 0;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Add the pending fragments to the transmit pool while it has room, one at a time for unicast.
+         * @return Number of fragments added.
+         */
+        size_t send(Protocol &protocol)
+        {
+            size_t sent = 0;
+            for (uint8_t i = 0; i < count_ && !failed(); i++)
+            {
+                if (state_[i] == State::QUEUED && unicast())
+                {
+                    break;
+                }
+                if (state_[i] != State::PENDING)
+                {
+                    continue;
+                }
+
+                auto packet = fragment(i);
+                if (!protocol.canAccept(packet.build().size()))
+                {
+                    break;
+                }
+
+                attempts_[i]++;
+                state_[i] = State::QUEUED;
+                auto result = protocol.sendPacket(packet, firstId_ + i);
+                if (result != Protocol::SendResult::ACCEPTED && result != Protocol::SendResult::REPLACED)
+                {
+                    state_[i] = attempts_[i] < MAX_ATTEMPTS ? State::PENDING : State::FAILED;
+                    break;
+                }
+                sent++;
+                if (unicast())
+                {
+                    break;
+                }
+            }
+            return sent;
+        }
+
+        /**
+         * @brief Update the state of a fragment from Connector::fanet_txStatus.
+         * @return True when the id belongs to a fragment of this message.
+         */
+        bool txStatus(uint16_t id, TxStatus status)
+        {
+            uint16_t index = id - firstId_;
+            if (index >= count_ || state_[index] != State::QUEUED)
+            {
+                return index < count_;
+            }
+
+            switch (status)
+            {
+            case TxStatus::ACKED:
+                state_[index] = State::DONE;
+                break;
+            case TxStatus::TRANSMITTED:
+                state_[index] = unicast() ? State::QUEUED : State::DONE;
+                break;
+            case TxStatus::TIMED_OUT:
+            case TxStatus::DROPPED:
+                state_[index] = attempts_[index] < MAX_ATTEMPTS ? State::PENDING : State::FAILED;
+                break;
+            default:
+                break;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Number of fragments of the message.
+         */
+        uint8_t fragments() const
+        {
+            return count_;
+        }
+
+        /**
+         * @brief Check if all fragments are acknowledged, or transmitted for broadcasts.
+         */
+        bool complete() const
+        {
+            return count_ > 0 && std::all_of(state_, state_ + count_, [](State s)
+                                             { return s == State::DONE; });
+        }
+
+        /**
+         * @brief Check if a fragment was not acknowledged after all attempts.
+         */
+        bool failed() const
+        {
+            return std::any_of(state_, state_ + count_, [](State s)
+                               { return s == State::FAILED; });
+        }
+    };
+
+    /**
+     * @brief Reassembles fragmented messages, one message per source at a time.
+     *
+     * Fragments may arrive in any order and more than once. A message that is not complete within the timeout
+     * is dropped, when all buffers are in use the buffer that was updated the longest time ago is reused.
+     *
+     * @tparam MAX_SOURCES Number of messages that are reassembled at the same time.
+     * @tparam MAX_MESSAGE Maximum length of a message.
+     * @tparam MAX_FRAGMENTS Maximum number of fragments of a message.
+     */
+    template <size_t MAX_SOURCES, size_t MAX_MESSAGE, size_t MAX_FRAGMENTS = 32>
+    class MessageReassembler
+    {
+        static_assert(MAX_FRAGMENTS <= 255, "Too many fragments");
+
+        struct Buffer
+        {
+            Address source;
+            uint8_t messageId;
+            uint8_t count;
+            uint16_t length;
+            uint32_t lastUpdate;
+            bool complete; // Kept until the timeout, so retransmitted fragments are not taken as a new message
+            etl::bitset<MAX_FRAGMENTS> received;
+            uint8_t data[MAX_MESSAGE];
+        };
+
+        etl::vector<Buffer, MAX_SOURCES> buffers_;
+        uint32_t timeoutMs_;
+
+        Buffer &buffer(const Address &source, uint8_t messageId, uint8_t count, uint16_t length)
+        {
+            auto it = std::find_if(buffers_.begin(), buffers_.end(), [&source](const Buffer &b)
+                                   { return b.source == source; });
+            if (it == buffers_.end())
+            {
+                if (buffers_.full())
+                {
+                    buffers_.erase(std::min_element(buffers_.begin(), buffers_.end(), [](const Buffer &a, const Buffer &b)
+                                                    { return static_cast<int32_t>(a.lastUpdate - b.lastUpdate) < 0; }));
+                }
+                buffers_.emplace_back();
+                it = buffers_.end() - 1;
+                it->source = source;
+            }
+            else if (it->messageId == messageId && it->count == count && it->length == length)
+            {
+                return *it;
+            }
+
+            // New message from this source
+            it->messageId = messageId;
+            it->count = count;
+            it->length = length;
+            it->complete = false;
+            it->received.reset();
+            return *it;
+        }
+
+    public:
+        /**
+         * @param timeoutMs A message that is not complete within this time after its last fragment is dropped.
+         */
+        MessageReassembler(uint32_t timeoutMs = FRAGMENT_REASSEMBLY_TIMEOUT_MS) : timeoutMs_(timeoutMs) {}
+
+        /**
+         * @brief Check if a message payload is a fragment.
+         * @param payload The raw message payload, starting with the sub-header.
+         */
+        static bool isFragment(etl::span<const uint8_t> payload)
+        {
+            return payload.size() > 1 + FRAGMENT_HEADER_SIZE && (payload[0] & FRAGMENT_SUBHEADER_FLAG);
+        }
+
+        /**
+         * @brief Add a received fragment.
+         * @param source The source address of the fragment.
+         * @param payload The raw message payload, starting with the sub-header.
+         * @param timeMs Time the fragment was received.
+         * @return The message when this fragment completed it, else empty. Valid until the next call.
+         */
+        etl::span<const uint8_t> add(const Address &source, etl::span<const uint8_t> payload, uint32_t timeMs)
+        {
+            expire(timeMs);
+            if (!isFragment(payload))
+            {
+                return {};
+            }
+
+            uint8_t messageId = payload[0] & 0x7F;
+            uint8_t index = payload[1];
+            uint8_t count = payload[2];
+            uint16_t length = (payload[3] << 8) | payload[4];
+            if (count == 0 || count > MAX_FRAGMENTS || index >= count || length > MAX_MESSAGE || length < count)
+            {
+                return {};
+            }
+
+            size_t fragmentSize = (length + count - 1) / count;
+            size_t offset = index * fragmentSize;
+            auto data = payload.subspan(1 + FRAGMENT_HEADER_SIZE);
+            if (offset >= length || data.size() != etl::min(fragmentSize, length - offset))
+            {
+                return {};
+            }
+
+            auto &b = buffer(source, messageId, count, length);
+            b.lastUpdate = timeMs;
+            if (b.complete || b.received.test(index))
+            {
+                return {};
+            }
+
+            memcpy(&b.data[offset], data.data(), data.size());
+            b.received.set(index);
+            if (b.received.count() != count)
+            {
+                return {};
+            }
+            b.complete = true;
+            return etl::span<const uint8_t>(b.data, length);
+        }
+
+        /**
+         * @brief Add a received packet, packets that are not message fragments are ignored.
+         */
+        etl::span<const uint8_t> add(const PacketView &packet, uint32_t timeMs)
+        {
+            if (packet.type() != Header::MessageType::MESSAGE)
+            {
+                return {};
+            }
+            return add(packet.source(), packet.payload(), timeMs);
+        }
+
+        /**
+         * @brief Drop messages that did not receive a fragment within the timeout.
+         * Messages updated after timeMs are kept.
+         */
+        void expire(uint32_t timeMs)
+        {
+            buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(), [this, timeMs](const Buffer &b)
+                                          { return static_cast<int32_t>(timeMs - b.lastUpdate) > static_cast<int32_t>(timeoutMs_); }),
+                           buffers_.end());
+        }
+
+        /**
+         * @brief Number of messages being reassembled, including completed ones that are kept until the timeout.
+         */
+        size_t size() const
+        {
+            return buffers_.size();
+        }
+    };
+}
@@ -19,14 +19,17 @@ namespace FANET
          */
         enum class MessageType : uint8_t
         {
-            ACK = 0,            // Acknowledgment
-            TRACKING = 1,       // Tracking
-            NAME = 2,           // Name
-            MESSAGE = 3,        // Message
-            SERVICE = 4,        // Service
-            LANDMARKS = 5,      // Landmarks
-            REMOTE_CONFIG = 6,  // Remote configuration
-            GROUND_TRACKING = 7 // Ground tracking
+            ACK = 0,             // Acknowledgment
+            TRACKING = 1,        // Tracking
+            NAME = 2,            // Name
+            MESSAGE = 3,         // Message
+            SERVICE = 4,         // Service
+            LANDMARKS = 5,       // Landmarks
+            REMOTE_CONFIG = 6,   // Remote configuration
+            GROUND_TRACKING = 7, // Ground tracking
+            HW_INFO_LEGACY = 8,  // Hardware info (deprecated)
+            THERMAL = 9,         // Thermal
+            HW_INFO = 10         // Hardware info
         };
 
     private:
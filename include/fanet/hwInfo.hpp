@@ -0,0 +1,351 @@
+#pragma once
+
+#include <stdint.h>
+#include "etl/algorithm.h"
+#include "header.hpp"
+#include "address.hpp"
+
+namespace FANET
+{
+    /**
+     * HW Info payload
+     * Messagetype : 10 (0xA)
+     *
+     * Optional fields are appended in header bit order 6 to 1. When the ping-pong bit is set the frame is a
+     * request and the remaining header bits indicate what is requested, no further data is added.
+     */
+    class HwInfoPayload final
+    {
+    private:
+        uint8_t header = 0;
+        uint8_t eHeader = 0;
+        uint8_t deviceTypeRaw = 0;
+        uint16_t buildDateRaw = 0;
+        uint32_t icaoRaw = 0;
+        uint16_t uptimeRaw = 0;
+        int8_t rssiRaw = 0;
+        Address rssiAddressRaw;
+
+    public:
+        /**
+         * @brief Default constructor.
+         */
+        HwInfoPayload() = default;
+
+        /**
+         * @brief Get the message type.
+         * @return The message type.
+         */
+        Header::MessageType type() const
+        {
+            return Header::MessageType::HW_INFO;
+        }
+
+        bool pingPongRequest() const
+        {
+            return header & 0x80;
+        }
+
+        /**
+         * @brief Turn this payload into a request, the other header bits indicate what is requested.
+         * A request must be send unicast.
+         */
+        HwInfoPayload &pingPongRequest(bool enabled)
+        {
+            if (enabled)
+            {
+                header |= 0x80;
+            }
+            else
+            {
+                header &= ~0x80;
+            }
+            return *this;
+        }
+
+        bool hasDeviceType() const
+        {
+            return header & 0x40;
+        }
+
+        bool hasIcaoAddress() const
+        {
+            return header & 0x20;
+        }
+
+        bool hasUptime() const
+        {
+            return header & 0x10;
+        }
+
+        bool hasRssi() const
+        {
+            return header & 0x08;
+        }
+
+        bool hasExtendedHeader() const
+        {
+            return header & 0x01;
+        }
+
+        /**
+         * @brief Get the manufacturer specific instrument / device type.
+         */
+        uint8_t deviceType() const
+        {
+            return deviceTypeRaw;
+        }
+
+        /**
+         * @brief Set the manufacturer specific instrument / device type together with the firmware build date.
+         * @param deviceType The device type.
+         * @param year The build year, 2019 up to 2082.
+         * @param month The build month (1-12).
+         * @param day The build day (1-31).
+         * @param experimental True for develop/experimental builds.
+         * @return Reference to the current object.
+         */
+        HwInfoPayload &deviceType(uint8_t deviceType, uint16_t year, uint8_t month, uint8_t day, bool experimental = false)
+        {
+            header |= 0x40;
+            deviceTypeRaw = deviceType;
+            buildDateRaw = (experimental ? 0x8000 : 0) |
+                           (etl::clamp(static_cast<int>(year) - 2019, 0, 0x3F) << 9) |
+                           (etl::clamp(static_cast<int>(month), 1, 12) << 5) |
+                           etl::clamp(static_cast<int>(day), 1, 31);
+            return *this;
+        }
+
+        /**
+         * @brief Get the raw firmware build date, suitable to compare firmware versions.
+         */
+        uint16_t buildDate() const
+        {
+            return buildDateRaw;
+        }
+
+        uint16_t buildYear() const
+        {
+            return 2019 + ((buildDateRaw >> 9) & 0x3F);
+        }
+
+        uint8_t buildMonth() const
+        {
+            return (buildDateRaw >> 5) & 0x0F;
+        }
+
+        uint8_t buildDay() const
+        {
+            return buildDateRaw & 0x1F;
+        }
+
+        bool experimental() const
+        {
+            return buildDateRaw & 0x8000;
+        }
+
+        /**
+         * @brief Get the 24 bit ICAO address.
+         */
+        uint32_t icaoAddress() const
+        {
+            return icaoRaw;
+        }
+
+        HwInfoPayload &icaoAddress(uint32_t icao)
+        {
+            header |= 0x20;
+            icaoRaw = icao & 0xFFFFFF;
+            return *this;
+        }
+
+        /**
+         * @brief Get the uptime in minutes.
+         */
+        uint16_t uptime() const
+        {
+            return uptimeRaw;
+        }
+
+        HwInfoPayload &uptime(uint16_t minutes)
+        {
+            header |= 0x10;
+            uptimeRaw = minutes;
+            return *this;
+        }
+
+        /**
+         * @brief Get the RSSI in dBm of the frame received from rssiAddress().
+         */
+        int16_t rssi() const
+        {
+            return static_cast<int16_t>(rssiRaw) - 50;
+        }
+
+        const Address &rssiAddress() const
+        {
+            return rssiAddressRaw;
+        }
+
+        /**
+         * @brief Set the RSSI at which a (unicast) request from address was received.
+         * @param dBm The RSSI in dBm.
+         * @param address Address of the requesting device.
+         * @return Reference to the current object.
+         */
+        HwInfoPayload &rssi(int16_t dBm, const Address &address)
+        {
+            header |= 0x08;
+            rssiRaw = etl::clamp(dBm + 50, -128, 127);
+            rssiAddressRaw = address;
+            return *this;
+        }
+
+        /**
+         * @brief Copy all fields that are present in other into this payload.
+         * Fields that are not present in other are kept.
+         * @param other The more recent payload.
+         * @return Reference to the current object.
+         */
+        HwInfoPayload &update(const HwInfoPayload &other)
+        {
+            if (other.hasDeviceType())
+            {
+                deviceTypeRaw = other.deviceTypeRaw;
+                buildDateRaw = other.buildDateRaw;
+            }
+            if (other.hasIcaoAddress())
+            {
+                icaoRaw = other.icaoRaw;
+            }
+            if (other.hasUptime())
+            {
+                uptimeRaw = other.uptimeRaw;
+            }
+            if (other.hasRssi())
+            {
+                rssiRaw = other.rssiRaw;
+                rssiAddressRaw = other.rssiAddressRaw;
+            }
+            if (other.hasExtendedHeader())
+            {
+                eHeader = other.eHeader;
+            }
+            header |= other.header & 0x7F;
+            return *this;
+        }
+
+        /**
+         * @brief Serialize the hw info payload to a bit stream.
+         * @param writer The bit stream writer.
+         */
+        void serialize(etl::bit_stream_writer &writer) const
+        {
+            writer.write_unchecked(header);
+            if (hasExtendedHeader())
+            {
+                writer.write_unchecked(eHeader);
+            }
+
+            if (pingPongRequest())
+            {
+                return;
+            }
+
+            if (hasDeviceType())
+            {
+                writer.write_unchecked(deviceTypeRaw);
+                writer.write_unchecked(etl::reverse_bytes(buildDateRaw));
+            }
+
+            if (hasIcaoAddress())
+            {
+                writer.write_unchecked(etl::reverse_bytes(icaoRaw << 8), 24U);
+            }
+
+            if (hasUptime())
+            {
+                writer.write_unchecked(etl::reverse_bytes(uptimeRaw));
+            }
+
+            if (hasRssi())
+            {
+                writer.write_unchecked(rssiRaw);
+                rssiAddressRaw.serialize(writer);
+            }
+        }
+
+        /**
+         * @brief Get the number of bytes of a payload with this header byte.
+         * @param header The first byte of the payload.
+         */
+        static size_t requiredSize(uint8_t header)
+        {
+            size_t size = (header & 0x01) ? 2 : 1;
+            if (header & 0x80)
+            {
+                return size;
+            }
+            size += (header & 0x40) ? 3 : 0; // Device type and build date
+            size += (header & 0x20) ? 3 : 0; // ICAO address
+            size += (header & 0x10) ? 2 : 0; // Uptime
+            size += (header & 0x08) ? 4 : 0; // Rssi and address
+            return size;
+        }
+
+        /**
+         * @brief Deserialize the hw info payload from a bit stream.
+         * @param reader The bit stream reader.
+         * @param payloadSize Number of bytes available for the payload.
+         * @return The deserialized hw info payload, without any fields when the payload is shorter than its header requires.
+         */
+        static HwInfoPayload deserialize(etl::bit_stream_reader &reader, size_t payloadSize)
+        {
+            HwInfoPayload hwInfo;
+            if (payloadSize < 1)
+            {
+                return hwInfo;
+            }
+
+            hwInfo.header = reader.read_unchecked<uint8_t>();
+            if (payloadSize < requiredSize(hwInfo.header))
+            {
+                hwInfo.header = 0;
+                return hwInfo;
+            }
+            if (hwInfo.hasExtendedHeader())
+            {
+                hwInfo.eHeader = reader.read_unchecked<uint8_t>();
+            }
+
+            if (hwInfo.pingPongRequest())
+            {
+                return hwInfo;
+            }
+
+            if (hwInfo.hasDeviceType())
+            {
+                hwInfo.deviceTypeRaw = reader.read_unchecked<uint8_t>();
+                hwInfo.buildDateRaw = etl::reverse_bytes(reader.read_unchecked<uint16_t>());
+            }
+
+            if (hwInfo.hasIcaoAddress())
+            {
+                hwInfo.icaoRaw = etl::reverse_bytes(reader.read_unchecked<uint32_t>(24U)) >> 8;
+            }
+
+            if (hwInfo.hasUptime())
+            {
+                hwInfo.uptimeRaw = etl::reverse_bytes(reader.read_unchecked<uint16_t>());
+            }
+
+            if (hwInfo.hasRssi())
+            {
+                hwInfo.rssiRaw = reader.read_unchecked<int8_t>();
+                hwInfo.rssiAddressRaw = Address::deserialize(reader);
+            }
+
+            return hwInfo;
+        }
+    };
+}
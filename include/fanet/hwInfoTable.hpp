@@ -0,0 +1,121 @@
+#pragma once
+
+#include <stdint.h>
+#include "etl/vector.h"
+
+#include "address.hpp"
+#include "hwInfo.hpp"
+
+namespace FANET
+{
+    /**
+     * @brief Bounded cache of the last HW info received per address.
+     *
+     * Fields of a new HW info frame are merged into the existing record, so a frame that only carries the uptime
+     * does not erase a previously received device type and build date.
+     * When the table is full the record that was updated the longest time ago is removed.
+     */
+    template <size_t MAX_ENTRIES>
+    class HwInfoTable
+    {
+    public:
+        struct Entry
+        {
+            Address address;
+            HwInfoPayload hwInfo;
+            uint32_t lastSeen;
+        };
+
+    private:
+        etl::vector<Entry, MAX_ENTRIES> entries_;
+
+    public:
+        void clear()
+        {
+            entries_.clear();
+        }
+
+        size_t size() const
+        {
+            return entries_.size();
+        }
+
+        /**
+         * @brief Add or merge the HW info of an address. Ping-pong requests carry no information and are ignored.
+         * @param address The source address of the HW info.
+         * @param hwInfo The received HW info.
+         * @param timeMs Time the HW info was received.
+         */
+        void addOrUpdate(const Address &address, const HwInfoPayload &hwInfo, uint32_t timeMs)
+        {
+            if (hwInfo.pingPongRequest())
+            {
+                return;
+            }
+
+            auto it = std::find_if(entries_.begin(), entries_.end(), [&address](const Entry &e)
+                                   { return e.address == address; });
+            if (it != entries_.end())
+            {
+                it->hwInfo.update(hwInfo);
+                it->lastSeen = timeMs;
+                return;
+            }
+
+            if (entries_.full())
+            {
+                removeOldest();
+            }
+            entries_.push_back(Entry{address, hwInfo, timeMs});
+        }
+
+        /**
+         * @brief Get the HW info of an address.
+         * @return The HW info, or nullptr when nothing was received from this address.
+         */
+        const HwInfoPayload *get(const Address &address) const
+        {
+            auto it = std::find_if(entries_.begin(), entries_.end(), [&address](const Entry &e)
+                                   { return e.address == address; });
+            if (it != entries_.end())
+            {
+                return &it->hwInfo;
+            }
+            return nullptr;
+        }
+
+        uint32_t lastSeen(const Address &address) const
+        {
+            auto it = std::find_if(entries_.begin(), entries_.end(), [&address](const Entry &e)
+                                   { return e.address == address; });
+            if (it != entries_.end())
+            {
+                return it->lastSeen;
+            }
+            return 0;
+        }
+
+        void remove(const Address &address)
+        {
+            entries_.erase(std::remove_if(entries_.begin(), entries_.end(), [&address](const Entry &e)
+                                          { return e.address == address; }),
+                           entries_.end());
+        }
+
+        void removeOldest()
+        {
+            auto it = std::min_element(entries_.begin(), entries_.end(), [](const Entry &a, const Entry &b)
+                                       { return a.lastSeen < b.lastSeen; });
+            if (it != entries_.end())
+            {
+                entries_.erase(it);
+            }
+        }
+
+        const etl::ivector<Entry> &entries() const
+        {
+            return entries_;
+        }
+    };
+
+}
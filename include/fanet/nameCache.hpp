@@ -0,0 +1,221 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "etl/string.h"
+
+#include "address.hpp"
+#include "addressIndex.hpp"
+
+namespace FANET
+{
+    /**
+     * @brief Bounded cache of the last name received per address.
+     *
+     * All names are stored in one arena as records of a flag byte, the address, the length and the bytes of the name.
+     * The AddressIndex refers to the records directly, so besides the index there is nothing kept per name. A changed
+     * name of a different length gets a new record and the old one becomes a gap, gaps are removed by compacting the
+     * arena once the end is reached. When the cache or the arena is full a name is removed with the CLOCK algorithm:
+     * a hand walks the records, names looked up or received again since the last pass get a second chance.
+     * A name costs 5 bytes plus its length in the arena and 4 to 8 bytes in the index.
+     *
+     * @tparam MAX_NAMES Number of names.
+     * @tparam ARENA_SIZE Size of the arena in bytes, each name takes 5 bytes plus its length.
+     */
+    template <size_t MAX_NAMES, size_t ARENA_SIZE>
+    class NameCache
+    {
+        static_assert(MAX_NAMES > 0 && MAX_NAMES < 0xFFFF, "MAX_NAMES must be between 1 and 65534");
+        static_assert(ARENA_SIZE < 0xFFFF, "ARENA_SIZE must be below 64KB");
+
+        using Index = AddressIndex<MAX_NAMES, uint16_t>;
+        static constexpr uint16_t NONE = Index::EMPTY;
+        static constexpr size_t RECORD_HEADER = 5; // Flags, address and length
+        static constexpr uint8_t LIVE = 0x01;       // Record holds a name, otherwise it is a gap
+        static constexpr uint8_t REFERENCED = 0x02; // Used since the hand passed
+
+        Index index_; // Offsets of the records
+        uint8_t arena_[ARENA_SIZE];
+        uint16_t end_ = 0;  // End of the last record
+        uint16_t used_ = 0; // Bytes of the records in use
+        uint16_t hand_ = 0; // Next record to consider for removal
+        uint16_t size_ = 0;
+
+        Address addressAt(uint16_t offset) const
+        {
+            return Address{arena_[offset + 1], static_cast<uint16_t>(arena_[offset + 2] | (arena_[offset + 3] << 8))};
+        }
+
+        uint16_t recordSize(uint16_t offset) const
+        {
+            return RECORD_HEADER + arena_[offset + 4];
+        }
+
+        size_t position(const Address &address) const
+        {
+            return index_.position(address, [this](uint16_t offset)
+                                   { return addressAt(offset); });
+        }
+
+        void removeRecord(uint16_t offset)
+        {
+            index_.unlink(position(addressAt(offset)), [this](uint16_t o)
+                          { return addressAt(o); });
+            arena_[offset] = 0;
+            used_ -= recordSize(offset);
+            size_--;
+        }
+
+        /**
+         * @brief Advance the hand until a name without a second chance is found and remove it.
+         */
+        void evict()
+        {
+            while (true)
+            {
+                if (hand_ >= end_)
+                {
+                    hand_ = 0;
+                }
+                uint16_t offset = hand_;
+                hand_ += recordSize(offset);
+                if (arena_[offset] == LIVE)
+                {
+                    removeRecord(offset);
+                    return;
+                }
+                arena_[offset] &= ~REFERENCED;
+            }
+        }
+
+        /**
+         * @brief Move all records in use to the start of the arena.
+         */
+        void compact()
+        {
+            uint16_t write = 0;
+            uint16_t hand = 0;
+            for (uint16_t read = 0; read < end_;)
+            {
+                uint16_t size = recordSize(read);
+                if (read == hand_)
+                {
+                    hand = write;
+                }
+                if (arena_[read] & LIVE)
+                {
+                    index_[position(addressAt(read))] = write;
+                    memmove(&arena_[write], &arena_[read], size);
+                    write += size;
+                }
+                read += size;
+            }
+            end_ = write;
+            hand_ = hand;
+        }
+
+    public:
+        void clear()
+        {
+            size_ = 0;
+            end_ = used_ = hand_ = 0;
+            index_.clear();
+        }
+
+        size_t size() const
+        {
+            return size_;
+        }
+
+        /**
+         * @brief Bytes of the arena used by names, including the record headers.
+         */
+        size_t bytesUsed() const
+        {
+            return used_;
+        }
+
+        /**
+         * @brief Store the name of an address. A name equal to the cached one only marks it as used.
+         * @param address The source address of the name.
+         * @param name The name, an empty name removes the address.
+         * @return True when the cached name changed.
+         */
+        bool update(const Address &address, etl::string_view name)
+        {
+            uint8_t nameLength = name.size() > 0xFF ? 0xFF : static_cast<uint8_t>(name.size());
+            auto offset = index_[position(address)];
+            if (offset != NONE)
+            {
+                if (arena_[offset + 4] == nameLength)
+                {
+                    auto stored = &arena_[offset + RECORD_HEADER];
+                    arena_[offset] |= REFERENCED;
+                    if (memcmp(stored, name.data(), nameLength) == 0)
+                    {
+                        return false;
+                    }
+                    memcpy(stored, name.data(), nameLength);
+                    return true;
+                }
+                removeRecord(offset);
+            }
+
+            uint16_t size = RECORD_HEADER + nameLength;
+            if (nameLength == 0 || size > ARENA_SIZE)
+            {
+                return offset != NONE;
+            }
+
+            while (size_ == MAX_NAMES || used_ + size > ARENA_SIZE)
+            {
+                evict();
+            }
+            if (end_ + size > ARENA_SIZE)
+            {
+                compact();
+            }
+
+            index_[position(address)] = end_;
+            arena_[end_] = LIVE;
+            arena_[end_ + 1] = address.manufacturer();
+            arena_[end_ + 2] = address.unique() & 0xFF;
+            arena_[end_ + 3] = address.unique() >> 8;
+            arena_[end_ + 4] = nameLength;
+            memcpy(&arena_[end_ + RECORD_HEADER], name.data(), nameLength);
+            end_ += size;
+            used_ += size;
+            size_++;
+            return true;
+        }
+
+        /**
+         * @brief Get the name of an address and mark it as used.
+         * @return The name, empty when it is not known. Valid until the next update.
+         */
+        etl::string_view name(const Address &address)
+        {
+            auto offset = index_[position(address)];
+            if (offset == NONE)
+            {
+                return etl::string_view();
+            }
+            arena_[offset] |= REFERENCED;
+            return etl::string_view(reinterpret_cast<const char *>(&arena_[offset + RECORD_HEADER]), arena_[offset + 4]);
+        }
+
+        bool contains(const Address &address) const
+        {
+            return index_[position(address)] != NONE;
+        }
+
+        void remove(const Address &address)
+        {
+            auto offset = index_[position(address)];
+            if (offset != NONE)
+            {
+                removeRecord(offset);
+            }
+        }
+    };
+}
@@ -8,6 +8,7 @@
 namespace FANET
 {
     static constexpr uint32_t NEIGHBOR_MAX_TIMEOUT_MS = 4 * 60 * 1000 + 10000; // 4min + 10sek
+    static constexpr int16_t NEIGHBOR_RSSI_UNKNOWN = -127;                       // Rssi of neighbors that are not in the table
 
     template <size_t FANET_MAX_NEIGHBORS>
     class NeighbourTable
@@ -17,6 +18,7 @@ namespace FANET
         {
             Address address;
             uint32_t lastSeen;
+            int16_t rssi; // Average of the last received frames in dBm
         };
         etl::vector<Neighbour, FANET_MAX_NEIGHBORS> neighborTable_;
 
@@ -30,7 +32,13 @@ namespace FANET
             return neighborTable_.size();
         }
 
-        void addOrUpdate(Address address, uint32_t lastSeen)
+        /**
+         * @brief Add a neighbor or update when it was last seen.
+         * @param address The address of the neighbor.
+         * @param lastSeen The time the neighbor was seen.
+         * @param rssi The rssi in dBm of the received frame, averaged with the previous frames.
+         */
+        void addOrUpdate(Address address, uint32_t lastSeen, int16_t rssi = NEIGHBOR_RSSI_UNKNOWN)
         {
             // THis is to simply the code, and 1ms is not a concern
             // So that lastSeen will always return a value
@@ -44,10 +52,14 @@ namespace FANET
             if (it != neighborTable_.end())
             {
                 it->lastSeen = lastSeen;
+                if (rssi != NEIGHBOR_RSSI_UNKNOWN)
+                {
+                    it->rssi = it->rssi == NEIGHBOR_RSSI_UNKNOWN ? rssi : (it->rssi + rssi) / 2;
+                }
             }
             else
             {
-                neighborTable_.push_back(Neighbour{address, lastSeen});
+                neighborTable_.push_back(Neighbour{address, lastSeen, rssi});
             }
         }
 
@@ -69,6 +81,20 @@ namespace FANET
             return 0;
         }
 
+        /**
+         * @brief Get the average rssi of a neighbor.
+         * @return The rssi in dBm, NEIGHBOR_RSSI_UNKNOWN when the neighbor is not in the table.
+         */
+        int16_t rssi(const Address &address) const
+        {
+            auto it = std::find_if(neighborTable_.begin(), neighborTable_.end(), [&address](const Neighbour &neighbour)
+                                   { return neighbour.address == address; });
+            if (it != neighborTable_.end())
+            {
+                return it->rssi;
+            }
+            return NEIGHBOR_RSSI_UNKNOWN;
+        }
 
         void removeOldest()
         {
@@ -85,8 +111,8 @@ namespace FANET
         {
             neighborTable_.erase(std::remove_if(neighborTable_.begin(), neighborTable_.end(), [&timeMs](const Neighbour &neighbour)
                                                { 
-                                                uint32_t diff = timeMs - neighbour.lastSeen;
-                                                return diff >  NEIGHBOR_MAX_TIMEOUT_MS; }),
+                                                int32_t diff = timeMs - neighbour.lastSeen;
+                                                return diff > static_cast<int32_t>(NEIGHBOR_MAX_TIMEOUT_MS); }),
                                 neighborTable_.end());
         }
 
@@ -11,11 +11,12 @@
 #include "groundTracking.hpp"
 #include "extendedHeader.hpp"
 #include "service.hpp"
+#include "hwInfo.hpp"
 
 namespace FANET
 {
     template <size_t MAXFRAMESIZE>
-    using PayloadVariant = etl::variant<TrackingPayload, NamePayload<MAXFRAMESIZE>, MessagePayload<MAXFRAMESIZE>, GroundTrackingPayload, ServicePayload>;
+    using PayloadVariant = etl::variant<TrackingPayload, NamePayload<MAXFRAMESIZE>, MessagePayload<MAXFRAMESIZE>, GroundTrackingPayload, ServicePayload, HwInfoPayload>;
 
     template <size_t MAXFRAMESIZE>
     class Packet
@@ -192,6 +193,13 @@ namespace FANET
             return *this;
         }
 
+        Packet &payload(const HwInfoPayload &hwInfoPayload)
+        {
+            header_.type(hwInfoPayload.type());
+            payload_ = PayloadVariant<MAXFRAMESIZE>(hwInfoPayload);
+            return *this;
+        }
+
         RadioPacket build() const
         {
             RadioPacket buffer;
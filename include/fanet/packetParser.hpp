@@ -1,6 +1,5 @@
 #pragma once
 
-#include "fanet.hpp"
 #include "etl/optional.h"
 #include "etl/vector.h"
 #include "etl/bit_stream.h"
@@ -11,6 +10,9 @@
 #include "name.hpp"
 #include "message.hpp"
 #include "groundTracking.hpp"
+#include "hwInfo.hpp"
+#include "service.hpp"
+#include "packet.hpp"
 
 namespace FANET
 {
@@ -20,7 +22,7 @@ namespace FANET
      * @tparam MAXFRAMESIZE The size of the name payload.
      */
     template <size_t MAXFRAMESIZE>
-    using PayloadVariant = etl::variant<TrackingPayload, NamePayload<MAXFRAMESIZE>, MessagePayload<MAXFRAMESIZE>, GroundTrackingPayload, ServicePayload>;
+    using PayloadVariant = etl::variant<TrackingPayload, NamePayload<MAXFRAMESIZE>, MessagePayload<MAXFRAMESIZE>, GroundTrackingPayload, ServicePayload, HwInfoPayload>;
 
     /**
      * @brief A class to parse FANET packets from a byte buffer.
@@ -75,28 +77,37 @@ namespace FANET
                 }
             }
 
-            switch (header.type())
+            optPayload = parsePayload(header.type(), reader, buffer.size() - headerSize);
+
+            return Packet<MAXFRAMESIZE>(header, source, optDestination, optExtHeader, optSignature, optPayload);
+        }
+
+        /**
+         * @brief Parse the payload of a FANET packet.
+         * @param type The message type from the header.
+         * @param reader Reader positioned at the start of the payload.
+         * @param length The length of the payload in bytes.
+         * @return The payload, empty for ACK or unsupported types.
+         */
+        static etl::optional<PayloadVariant<MAXFRAMESIZE>> parsePayload(Header::MessageType type, etl::bit_stream_reader &reader, size_t length)
+        {
+            switch (type)
             {
             case Header::MessageType::TRACKING:
-                optPayload = TrackingPayload::deserialize(reader);
-                break;
+                return PayloadVariant<MAXFRAMESIZE>(TrackingPayload::deserialize(reader, length));
             case Header::MessageType::NAME:
-                optPayload = NamePayload<MAXFRAMESIZE>::deserialize(reader, buffer.size() - headerSize);
-                break;
+                return PayloadVariant<MAXFRAMESIZE>(NamePayload<MAXFRAMESIZE>::deserialize(reader, length));
             case Header::MessageType::MESSAGE:
-                optPayload = MessagePayload<MAXFRAMESIZE>::deserialize(reader, buffer.size() - headerSize);
-                break;
+                return PayloadVariant<MAXFRAMESIZE>(MessagePayload<MAXFRAMESIZE>::deserialize(reader, length));
             case Header::MessageType::GROUND_TRACKING:
-                optPayload = GroundTrackingPayload::deserialize(reader);
-                break;
+                return PayloadVariant<MAXFRAMESIZE>(GroundTrackingPayload::deserialize(reader));
             case Header::MessageType::SERVICE:
-                optPayload = ServicePayload::deserialize(reader, buffer.size() - headerSize);
-                break;
+                return PayloadVariant<MAXFRAMESIZE>(ServicePayload::deserialize(reader, length));
+            case Header::MessageType::HW_INFO:
+                return PayloadVariant<MAXFRAMESIZE>(HwInfoPayload::deserialize(reader, length));
             default:
-                break; // ACK or unsupported types
+                return etl::nullopt; // ACK or unsupported types
             }
-
-            return Packet<MAXFRAMESIZE>(header, source, optDestination, optExtHeader, optSignature, optPayload);
         }
     };
 };
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h>
+#include "etl/optional.h"
+#include "etl/span.h"
+#include "etl/bit_stream.h"
+
+#include "header.hpp"
+#include "address.hpp"
+#include "extendedHeader.hpp"
+#include "txFrame.hpp"
+#include "packetParser.hpp"
+
+namespace FANET
+{
+    /**
+     * @brief Read only view on a received frame, as handed to Connector::fanet_packetReceived.
+     *
+     * The header fields are read directly from the frame, the payload is only decoded when asked for.
+     * The view points into the receive buffer and is only valid during the callback.
+     */
+    class PacketView
+    {
+        TxFrame<const uint8_t> frame_;
+
+    public:
+        explicit PacketView(etl::span<const uint8_t> frame) : frame_(frame) {}
+
+        Header::MessageType type() const
+        {
+            return frame_.type();
+        }
+
+        Address source() const
+        {
+            return frame_.source();
+        }
+
+        /**
+         * @brief Get the destination address, Address{} for broadcasts.
+         */
+        Address destination() const
+        {
+            return frame_.destination();
+        }
+
+        bool forward() const
+        {
+            return frame_.forward();
+        }
+
+        ExtendedHeader::AckType ackType() const
+        {
+            return frame_.ackType();
+        }
+
+        /**
+         * @brief Get the raw payload.
+         */
+        etl::span<const uint8_t> payload() const
+        {
+            return frame_.payload();
+        }
+
+        /**
+         * @brief Get the raw frame, including the header.
+         */
+        etl::span<const uint8_t> frame() const
+        {
+            return frame_.data();
+        }
+
+        /**
+         * @brief Decode the payload.
+         * @tparam MAXFRAMESIZE The size of the message and name payload.
+         * @return The payload, empty for ACK or unsupported types.
+         */
+        template <size_t MAXFRAMESIZE>
+        etl::optional<PayloadVariant<MAXFRAMESIZE>> decodePayload() const
+        {
+            auto data = payload();
+            etl::bit_stream_reader reader((uint8_t *)data.data(), data.size(), etl::endian::big);
+            return PacketParser<MAXFRAMESIZE>::parsePayload(type(), reader, data.size());
+        }
+    };
+}
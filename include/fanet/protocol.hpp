@@ -6,6 +6,7 @@
 #include "etl/bit_stream.h"
 #include "etl/variant.h"
 #include "etl/random.h"
+#include "etl/array.h"
 
 #include "header.hpp"
 #include "address.hpp"
@@ -18,9 +19,35 @@
 #include "groundTracking.hpp"
 #include "blockAllocator.hpp"
 #include "packetParser.hpp"
+#include "packetView.hpp"
 #include "neighbourTable.hpp"
+#include "hwInfoTable.hpp"
+#include "trafficTable.hpp"
+#include "nameCache.hpp"
+#include "weatherTable.hpp"
+#include "dutyCycle.hpp"
+#include "tokenBucket.hpp"
+#include "beacon.hpp"
+#include "codingRate.hpp"
+#include "rxQueue.hpp"
+#include "txQueue.hpp"
 #include "connector.hpp"
 
+// Sizes of the tables filled from received frames, define them before this file is included or as build flags.
+// A tracker that does not show other aircraft can keep them small, e.g. -DFANET_MAX_TRAFFIC=1 -DFANET_MAX_NAMES=1 -DFANET_NAME_ARENA=32 -DFANET_MAX_WEATHER=1
+#ifndef FANET_MAX_TRAFFIC
+#define FANET_MAX_TRAFFIC 32 // Aircraft in the traffic table, at most 127
+#endif
+#ifndef FANET_MAX_NAMES
+#define FANET_MAX_NAMES 32 // Names in the name cache
+#endif
+#ifndef FANET_NAME_ARENA
+#define FANET_NAME_ARENA 512 // Bytes for all names in the name cache
+#endif
+#ifndef FANET_MAX_WEATHER
+#define FANET_MAX_WEATHER 8 // Weather stations in the weather table, about 500 bytes each
+#endif
+
 namespace FANET
 {
     /**
@@ -44,10 +71,50 @@ namespace FANET
             uint32_t fwdDbBoostDrop = 0;     // Pkts dropped from txQueue with subsequent good rssi
             uint32_t fwdDbBoostWeak = 0;     // Pkts forwarded that was in our TX queue due seeing a rxmit with a poor rssi
             uint32_t fwdDropAirtime = 0;     // Packets dropped due to too much time on the air recently.
+            uint32_t fwdDropBucket = 0;      // Forwarded packets dropped because the forward token bucket was empty
+            uint32_t txDeferTracking = 0;    // Own tracking packets deferred because the tracking token bucket was empty
+            uint32_t txDeferOther = 0;       // Own other packets deferred because their token bucket was empty
+            uint32_t txDeferAck = 0;         // Acks deferred because the ack token bucket was empty
             uint32_t rxFromUsDrp = 0;        // Dropped packets from our own Mac
             uint32_t txAck = 0;              // Number of Acks sent
             uint32_t neighborTableSize = 0;  // Number of neighbors currently in our neighbor table
+            int32_t crAirtimeSaved = 0;      // Airtime in ms saved by the coding rate policy compared to the neighbor count rule
+            uint32_t csmaBusy = 0;           // Transmissions backed off because fanet_channelBusy reported activity
+            uint32_t rxDuplicate = 0;        // Packets dropped because another radio received the same frame
+        };
+
+        /**
+         * @brief Result of sendPacket.
+         */
+        enum class SendResult : uint8_t
+        {
+            ACCEPTED,          // Added to the transmit pool
+            REPLACED,          // Added, the oldest queued packet of the same type was removed
+            SUPERSEDED,        // The queued tracking, ground tracking or service packet to the same destination was updated
+            POOL_FULL,         // Not added, there is no room in the transmit pool
+            AIRTIME_EXHAUSTED, // Not added, the duty cycle budget is used up
+            DUPLICATE,         // Not added, the same packet is already queued
         };
+
+        /**
+         * @brief Admission of the packets of the application, see admissionPolicy().
+         */
+        struct AdmissionPolicy
+        {
+            bool rejectDuplicates = true;       // Reject a packet when the same bytes are already queued
+            bool rejectWithoutAirtime = false;  // Reject packets while the duty cycle budget is used up, except tracking, instead of deferring them
+            bool replaceOldestSameType = false; // A new packet replaces the oldest queued packet of the same type
+        };
+
+        /**
+         * @brief State of the carrier sense multiple access.
+         */
+        enum class CsmaState : uint8_t
+        {
+            IDLE,    // Channel was free at the last transmission
+            BACKOFF, // Channel was busy, waiting a random number of slots before listening again
+        };
+
     protected:
 
         static constexpr int32_t MAC_SLOT_MS = 20;
@@ -65,9 +132,16 @@ namespace FANET
         static constexpr int32_t MAC_FORWARD_DELAY_MIN = 100;
         static constexpr int32_t MAC_FORWARD_DELAY_MAX = 300;
         static constexpr int32_t FANET_MAX_NEIGHBORS = 30;
+        static constexpr int32_t FANET_MAX_HWINFO = 16;
+        static constexpr int32_t FANET_MAX_DUTYCYCLE_RECORDS = 64;
+        static constexpr int32_t FANET_RX_QUEUE_SIZE = 4;
+        static constexpr int32_t FANET_TX_QUEUE_SIZE = 8;
+        static constexpr int32_t FANET_MAX_INTERFACES = 2;
+        static constexpr int32_t FANET_RX_DUPLICATES = 8;
+        static constexpr int32_t MAC_RX_DUPLICATE_MS = 50; // Shorter than MAC_FORWARD_DELAY_MIN so forwards are not taken as duplicates
 
         static constexpr int32_t APP_TYPE1OR7_MINTAU_MS = 250;
-        static constexpr int32_t APP_TYPE1OR7_TAU_MS = 5000;
+        static constexpr int32_t APP_TYPE1OR7_TAU_MS = BeaconScheduler::TRACKING_TAU_MS;
 
         static constexpr int32_t FANET_CSMA_MIN = 20;
         static constexpr int32_t FANET_CSMA_MAX = 40;
@@ -77,6 +151,16 @@ namespace FANET
 
         static constexpr int16_t MAC_DEFAULT_TX_BACKOFF = 1000;
 
+        // Default token buckets per traffic class, rate in ms of airtime per second and burst in ms of airtime
+        static constexpr uint16_t BUCKET_OWN_TRACKING_RATE = 100;
+        static constexpr uint16_t BUCKET_OWN_TRACKING_BURST = 500;
+        static constexpr uint16_t BUCKET_OWN_OTHER_RATE = 50;
+        static constexpr uint16_t BUCKET_OWN_OTHER_BURST = 500;
+        static constexpr uint16_t BUCKET_ACK_RATE = 50;
+        static constexpr uint16_t BUCKET_ACK_BURST = 250;
+        static constexpr uint16_t BUCKET_FORWARD_RATE = 100;
+        static constexpr uint16_t BUCKET_FORWARD_BURST = 500;
+
         // Random number generator for random times
         etl::random_xorshift random; // XOR-Shift PRNG from ETL
 
@@ -87,18 +171,77 @@ namespace FANET
         // Table with received neighbors
         NeighbourTable<FANET_MAX_NEIGHBORS> neighborTable_;
 
+        // Last HW info received per address
+        HwInfoTable<FANET_MAX_HWINFO> hwInfoTable_;
+
+        // Latest state per address from tracking and ground tracking frames
+        TrafficTable<FANET_MAX_TRAFFIC> trafficTable_;
+
+        // Last name received per address
+        NameCache<FANET_MAX_NAMES, FANET_NAME_ARENA> nameCache_;
+
+        // Latest report and statistics per weather station from service frames
+        WeatherTable<FANET_MAX_WEATHER> weatherTable_;
+
         // User's own address
         Address ownAddress_{1}; // Default to 1 to ensure 'ownAddress_' is not broadcast
         // When set to true, the protocol handler will forward received packages when applicable
         bool doForward = true;
 
-        // When has been set, then this is taken into consideration when to send the next packet
-        // This is like CSMA in the old protocol.
-        uint32_t cmcaNextTx = 0;
-        uint8_t carrierBackoffExp = MAC_TX_BACKOFF_EXP_MIN;
-        Airtime airtime;
+        // A radio, each radio has its own carrier sense and duty cycle
+        struct Interface
+        {
+            Connector *connector = nullptr;
+            // When has been set, then this is taken into consideration when to send the next packet
+            // This is like CSMA in the old protocol.
+            uint32_t cmcaNextTx = 0;
+            uint8_t carrierBackoffExp = MAC_TX_BACKOFF_EXP_MIN;
+            CsmaState csmaState = CsmaState::IDLE;
+            // Radios with the same channel share the air and never transmit at the same time
+            uint8_t channel = 0;
+            // Airtime of all frames transmitted by this radio within the duty cycle window
+            DutyCycle<FANET_MAX_DUTYCYCLE_RECORDS> dutyCycle;
+        };
+
+        // All radios, the first one is the connector given to the constructor
+        etl::vector<Interface, FANET_MAX_INTERFACES> interfaces_;
+        DutyCycleLimits dutyCycleLimits_;
+
+        // Recently received frames, to drop a frame that was received by more than one radio
+        struct RecentFrame
+        {
+            uint32_t hash = 0;
+            uint32_t timeMs = 0;
+            uint8_t interface = 0xFF;
+        };
+        etl::array<RecentFrame, FANET_RX_DUPLICATES> recentFrames_;
+        uint8_t recentFramesIndex_ = 0;
+
+        // Airtime admission per traffic class, so bursts of one class cannot starve the others
+        etl::array<TokenBucket, TRAFFIC_CLASS_COUNT> tokenBuckets_ = {
+            TokenBucket{BUCKET_OWN_TRACKING_RATE, BUCKET_OWN_TRACKING_BURST},
+            TokenBucket{BUCKET_OWN_OTHER_RATE, BUCKET_OWN_OTHER_BURST},
+            TokenBucket{BUCKET_ACK_RATE, BUCKET_ACK_BURST},
+            TokenBucket{BUCKET_FORWARD_RATE, BUCKET_FORWARD_BURST},
+        };
+
+        // Periodic tracking, name and service beacons of the application
+        BeaconScheduler beacons_;
+
+        // Admission of the packets of the application
+        AdmissionPolicy admissionPolicy_;
+
+        // Chooses the coding rate per frame, when not set the rate is based on the number of neighbors
+        CodingRatePolicy *codingRatePolicy_ = nullptr;
+
+        // Frames received by the radio driver, handled by processRxQueue
+        RxQueue<FANET_RX_QUEUE_SIZE> rxQueue_;
+
+        // Frames submitted by other tasks, added to the txPool by handleTx
+        TxQueue<FANET_TX_QUEUE_SIZE> txQueue_;
 
         // Connector for the application, e.g., the interface between the FANET protocol and the application
+        // With more than one radio this is the first radio, it provides the tick and receives the acks
         Connector *connector;
 
         // Statistics for the protocol's operation
@@ -133,6 +276,22 @@ namespace FANET
             return static_cast<int32_t>(tick - time) >= 0;
         }
 
+        /**
+         * @brief The earlier of two ticks, taking the wrap around into account
+         */
+        static uint32_t earlier(uint32_t a, uint32_t b)
+        {
+            return static_cast<int32_t>(a - b) <= 0 ? a : b;
+        }
+
+        /**
+         * @brief The later of two ticks, taking the wrap around into account
+         */
+        static uint32_t later(uint32_t a, uint32_t b)
+        {
+            return static_cast<int32_t>(a - b) >= 0 ? a : b;
+        }
+
         /**
          * @brief Find a frame in the TX pool that matches the given buffer.
          * Matches are based on source, data.size, destination, type and the payload
@@ -178,6 +337,7 @@ namespace FANET
                 if (it->destination() == source && it->ackType() != ExtendedHeader::AckType::NONE)
                 {
                     id = it->id();
+                    txStatus(&*it, TxStatus::ACKED);
                     it = txPool.remove(it);
                 }
                 else
@@ -197,22 +357,56 @@ namespace FANET
          * c) Find any acknowledgment packet.
          * d) Find any other packet.
          *
-         * Packages of equal priority will be ordered by nextTx time, lowest first
+         * Packages of equal priority will be ordered by nextTx time, lowest first.
+         * Frames that no radio can send now, because their radio waits for the carrier sense or is out of airtime,
+         * are skipped so they do not hold back frames for the other radios.
          *
          * @param timeMs The current time in milliseconds.
+         * @param readyMs Set to the earliest time a skipped frame can be send, left alone when none was skipped.
          * @return A pointer to the next TX frame, or nullptr if no frame is available.
          */
-        TxFrame<uint8_t> *getNextTxFrame(uint32_t timeMs)
+        TxFrame<uint8_t> *getNextTxFrame(uint32_t timeMs, uint32_t &readyMs)
         {
             TxFrame<uint8_t> *nextFrame = nullptr;
             uint8_t highestPriority = 4; // 1 = self, 2 = priority, 3 = ack, 4 = other
             uint32_t earliestTime = UINT32_MAX;
+            bool skipped = false;
+
+            // Per radio the time it can send, own tracking does not need airtime
+            etl::array<uint32_t, FANET_MAX_INTERFACES> readyAny;
+            etl::array<uint32_t, FANET_MAX_INTERFACES> readyAirtime;
+            for (size_t i = 0; i < interfaces_.size(); i++)
+            {
+                auto &radio = interfaces_[i];
+                readyAny[i] = timeReached(timeMs, radio.cmcaNextTx) ? timeMs : radio.cmcaNextTx;
+                readyAirtime[i] = later(readyAny[i], timeMs + radio.dutyCycle.timeUntil(timeMs, dutyCycleLimits_.txPermille));
+            }
 
             for (auto it = txPool.begin(); it != txPool.end(); ++it)
             {
                 if (!timeReached(timeMs, it->nextTx()))
                     continue;
 
+                auto &ready = it->self() && it->isTrackingType() ? readyAny : readyAirtime;
+                uint32_t frameReady = ready[0];
+                if (it->interface() < interfaces_.size())
+                {
+                    frameReady = ready[it->interface()];
+                }
+                else
+                {
+                    for (size_t i = 1; i < interfaces_.size(); i++)
+                    {
+                        frameReady = earlier(frameReady, ready[i]);
+                    }
+                }
+                if (!timeReached(timeMs, frameReady))
+                {
+                    readyMs = skipped ? earlier(readyMs, frameReady) : frameReady;
+                    skipped = true;
+                    continue;
+                }
+
                 int priorityLevel = 4;
                 if (it->self())
                 {
@@ -242,21 +436,302 @@ namespace FANET
             return nextFrame;
         }
 
-        auto sendFrame(TxFrame<uint8_t> *frm)
+        uint8_t defaultCodingRate() const
+        {
+            return neighborTable_.size() < MAC_CODING48_THRESHOLD ? 8 : 5;
+        }
+
+        uint8_t codingRate(const TxFrame<uint8_t> *frm)
+        {
+            if (codingRatePolicy_ == nullptr)
+            {
+                return defaultCodingRate();
+            }
+
+            auto destination = frm->destination();
+            auto request = CodingRateRequest{
+                destination,
+                destination == Address{} ? NEIGHBOR_RSSI_UNKNOWN : neighborTable_.rssi(destination),
+                static_cast<uint16_t>(frm->data().size()),
+                neighborTable_.size(),
+                remainingAirtime(connector->fanet_getTick(), dutyCycleLimits_.txPermille),
+                defaultCodingRate()};
+            return etl::clamp<uint8_t>(codingRatePolicy_->codingRate(request), 5, 8);
+        }
+
+        uint16_t frameAirtime(const TxFrame<uint8_t> *frm)
+        {
+            return FanetAirtime::get(frm->data().size(), codingRate(frm) - 4);
+        }
+
+        TrafficClass trafficClass(const TxFrame<uint8_t> *frm) const
+        {
+            if (frm->type() == Header::MessageType::ACK)
+            {
+                return TrafficClass::ACK;
+            }
+            if (!frm->self())
+            {
+                return TrafficClass::FORWARD;
+            }
+            return frm->isTrackingType() ? TrafficClass::OWN_TRACKING : TrafficClass::OWN_OTHER;
+        }
+
+        /**
+         * @brief Prepare a packet of the application, the source is our own address and packets that request
+         * an ack are forwarded.
+         * @return The number of retransmissions.
+         */
+        template <size_t MAXFRAMESIZE>
+        uint8_t ownPacket(Packet<MAXFRAMESIZE> &packet) const
+        {
+            packet.source(ownAddress_);
+            auto eh = packet.extendedHeader().value_or(ExtendedHeader{});
+            // Forward must be true when extended header has a ackType none NONE
+            if (eh.ack() != ExtendedHeader::AckType::NONE)
+            {
+                packet.forward(true);
+                return MAC_TX_RETRANSMISSION_RETRYS;
+            }
+            return 0;
+        }
+
+        /**
+         * @brief Move the packets submitted by other tasks into the transmit pool, with the same admission as sendPacket.
+         * Packets stay in the queue while the pool is full.
+         */
+        void processTxQueue(uint32_t timeMs)
+        {
+            for (auto submission = txQueue_.front(); submission != nullptr; submission = txQueue_.front())
+            {
+                auto data = submission->frame();
+                auto txFrame = TxFrame<uint8_t>{{const_cast<uint8_t *>(data.data()), data.size()}}.self(true).id(submission->id).nextTx(timeMs).numTx(submission->numTx);
+                auto result = admit(txFrame);
+                if (result == SendResult::POOL_FULL)
+                {
+                    return;
+                }
+                connector->fanet_txStatus(submission->id, admitted(result) ? TxStatus::QUEUED : TxStatus::REJECTED);
+                txQueue_.pop();
+            }
+        }
+
+        /**
+         * @brief Find an own beacon of the same kind that was not send yet, it is superseded by a more recent one.
+         */
+        TxFrame<uint8_t> *queuedBeacon(BeaconType type)
+        {
+            for (auto &frm : txPool)
+            {
+                bool sameKind = (type == BeaconType::TRACKING && frm.isTrackingType()) ||
+                                (type == BeaconType::NAME && frm.type() == Header::MessageType::NAME) ||
+                                (type == BeaconType::SERVICE && frm.type() == Header::MessageType::SERVICE);
+                if (frm.self() && sameKind && frm.destination() == Address{})
+                {
+                    return &frm;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief Ask the providers of all beacons that are due for a packet and queue it.
+         * A beacon of the same kind that is still queued is superseded and keeps its place in the schedule.
+         * Name and service beacons give way to other traffic once the airtime reaches the forward limit.
+         */
+        void handleBeacons(uint32_t timeMs)
+        {
+            for (uint8_t i = 0; i < BEACON_TYPE_COUNT; i++)
+            {
+                auto type = static_cast<BeaconType>(i);
+                if (!beacons_.due(type, timeMs))
+                {
+                    continue;
+                }
+
+                if (type != BeaconType::TRACKING && remainingAirtime(timeMs, dutyCycleLimits_.forwardPermille) == 0)
+                {
+                    beacons_.postpone(type, timeMs + airtimeUntil(timeMs, dutyCycleLimits_.forwardPermille));
+                    continue;
+                }
+
+                Packet<FANET_BEACON_MAXFRAMESIZE> packet;
+                if (beacons_.provider(type)->fanet_beacon(type, packet) && packet.payload())
+                {
+                    uint8_t numTx = ownPacket(packet);
+                    auto v = packet.build();
+                    auto txFrame = TxFrame<uint8_t>{{v.data(), v.size()}}.self(true).nextTx(timeMs).numTx(numTx);
+                    admitOwnFrame(txFrame, queuedBeacon(type));
+                }
+                beacons_.sent(type, timeMs, neighborTable_.size());
+            }
+        }
+
+        /**
+         * @brief Get the airtime left on the radio with the largest budget.
+         */
+        uint32_t remainingAirtime(uint32_t timeMs, uint16_t limitPermille)
+        {
+            uint32_t remaining = 0;
+            for (auto &radio : interfaces_)
+            {
+                remaining = etl::max(remaining, radio.dutyCycle.remaining(timeMs, limitPermille));
+            }
+            return remaining;
+        }
+
+        /**
+         * @brief Get the time until the first radio has airtime left.
+         */
+        uint32_t airtimeUntil(uint32_t timeMs, uint16_t limitPermille)
+        {
+            uint32_t until = UINT32_MAX;
+            for (auto &radio : interfaces_)
+            {
+                until = etl::min(until, radio.dutyCycle.timeUntil(timeMs, limitPermille));
+            }
+            return until;
+        }
+
+        /**
+         * @brief Choose the radio for the next transmission.
+         * Of the radios that are not waiting for the carrier sense, the one with the most airtime left is used.
+         * When all are waiting, the one that is ready first is returned.
+         */
+        Interface &nextInterface(uint32_t timeMs)
+        {
+            Interface *next = &interfaces_.front();
+            uint32_t nextRemaining = 0;
+            bool ready = false;
+            for (auto &radio : interfaces_)
+            {
+                if (timeReached(timeMs, radio.cmcaNextTx))
+                {
+                    auto remaining = radio.dutyCycle.remaining(timeMs, dutyCycleLimits_.txPermille);
+                    if (!ready || remaining > nextRemaining)
+                    {
+                        next = &radio;
+                        nextRemaining = remaining;
+                        ready = true;
+                    }
+                }
+                else if (!ready && static_cast<int32_t>(radio.cmcaNextTx - next->cmcaNextTx) < 0)
+                {
+                    next = &radio;
+                }
+            }
+            return *next;
+        }
+
+        /**
+         * @brief Get the time the first radio is ready to send.
+         */
+        uint32_t nextInterfaceTx(uint32_t timeMs)
+        {
+            auto &radio = nextInterface(timeMs);
+            return timeReached(timeMs, radio.cmcaNextTx) ? timeMs : radio.cmcaNextTx;
+        }
+
+        /**
+         * @brief Channel busy, increment the backoff exponent and wait a random time before the next try.
+         * @return The time of the next try on any radio.
+         */
+        uint32_t backoff(Interface &radio, uint32_t timeMs)
+        {
+            radio.csmaState = CsmaState::BACKOFF;
+            if (radio.carrierBackoffExp < MAC_TX_BACKOFF_EXP_MAX)
+            {
+                radio.carrierBackoffExp++;
+            }
+
+            radio.cmcaNextTx = timeMs + random.range(1 << (MAC_TX_BACKOFF_EXP_MIN - 1), 1 << radio.carrierBackoffExp);
+            return nextInterfaceTx(timeMs);
+        }
+
+        /**
+         * @brief Listen before talk, ask the radio for channel activity right before a transmission.
+         * @return True when the channel is free, else a backoff has been scheduled.
+         */
+        bool channelFree(Interface &radio, uint32_t timeMs)
+        {
+            if (radio.connector->fanet_channelBusy())
+            {
+                stats_.csmaBusy++;
+                backoff(radio, timeMs);
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Transmission done, the backoff starts again at the minimum.
+         * @return The time of the next transmission on any radio.
+         */
+        uint32_t transmitted(Interface &radio, uint32_t timeMs, uint16_t lengthBytes)
+        {
+            radio.csmaState = CsmaState::IDLE;
+            radio.carrierBackoffExp = MAC_TX_BACKOFF_EXP_MIN;
+            radio.cmcaNextTx = timeMs + MAC_TX_MINPREAMBLEHEADERTIME_MS + (lengthBytes * MAC_TX_TIMEPERBYTE_MS);
+            // Other radios on the same channel wait until the air is free again
+            for (auto &other : interfaces_)
+            {
+                if (other.channel == radio.channel && static_cast<int32_t>(other.cmcaNextTx - radio.cmcaNextTx) < 0)
+                {
+                    other.cmcaNextTx = radio.cmcaNextTx;
+                }
+            }
+            return nextInterfaceTx(timeMs);
+        }
+
+        /**
+         * @brief Check if the same frame was just received by another radio, else remember the frame.
+         */
+        bool receivedByOtherInterface(etl::span<const uint8_t> buffer, uint32_t timeMs, uint8_t interface)
+        {
+            // FNV-1a
+            uint32_t hash = 2166136261u;
+            for (auto byte : buffer)
+            {
+                hash = (hash ^ byte) * 16777619u;
+            }
+
+            for (const auto &recent : recentFrames_)
+            {
+                if (recent.hash == hash && recent.interface != interface && recent.interface != 0xFF &&
+                    static_cast<uint32_t>(etl::absolute(static_cast<int32_t>(timeMs - recent.timeMs))) <= MAC_RX_DUPLICATE_MS)
+                {
+                    return true;
+                }
+            }
+
+            recentFrames_[recentFramesIndex_] = RecentFrame{hash, timeMs, interface};
+            recentFramesIndex_ = (recentFramesIndex_ + 1) % FANET_RX_DUPLICATES;
+            return false;
+        }
+
+        /**
+         * @brief Send a frame on a radio, the airtime is only charged to the duty cycle and the token bucket
+         * when the radio accepted the frame.
+         */
+        auto sendFrame(Interface &radio, TxFrame<uint8_t> *frm)
         {
             struct ret
             {
                 bool isSend;
                 uint16_t lengthBytes;
             };
-            auto cr = neighborTable_.size() < MAC_CODING48_THRESHOLD ? 8 : 5;
+            auto cr = codingRate(frm);
             uint16_t lengthBytes = frm->data().size();
-            auto airTime = FANET::LoraAirtime(lengthBytes, 7, 250, cr - 4);
-            airtime.set(connector->fanet_getTick(), airTime);
-            // printf("Length bytes : length:%d time:%d airTime:%d\n", lengthBytes, airTime, airtime.get(connector->fanet_getTick()));
-            return ret{
-                connector->fanet_sendFrame(cr, frm->data()),
-                lengthBytes};
+            auto timeMs = connector->fanet_getTick();
+            bool isSend = radio.connector->fanet_sendFrame(cr, frm->data());
+            if (isSend)
+            {
+                auto airTime = FanetAirtime::get(lengthBytes, cr - 4);
+                stats_.crAirtimeSaved += FanetAirtime::get(lengthBytes, defaultCodingRate() - 4) - airTime;
+                radio.dutyCycle.set(timeMs, airTime);
+                tokenBuckets_[static_cast<uint8_t>(trafficClass(frm))].consume(timeMs, airTime);
+            }
+            return ret{isSend, lengthBytes};
         }
 
         void ackReceived(uint16_t id)
@@ -264,6 +739,163 @@ namespace FANET
             return connector->fanet_ackReceived(id);
         }
 
+        /**
+         * @brief Inform the application about a packet it has send, frames of others are ignored.
+         */
+        void txStatus(const TxFrame<uint8_t> *frm, TxStatus status)
+        {
+            if (frm->self())
+            {
+                connector->fanet_txStatus(frm->id(), status);
+            }
+        }
+
+        /**
+         * @brief Find the same frame of the application in the transmit pool.
+         */
+        TxFrame<uint8_t> *queuedDuplicate(const TxFrame<uint8_t> &txFrame)
+        {
+            auto data = txFrame.data();
+            for (auto &frm : txPool)
+            {
+                if (frm.self() && frm.data().size() == data.size() && etl::equal(data.begin(), data.end(), frm.data().begin()))
+                {
+                    return &frm;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief Find the queued frame of the application of the given type that is scheduled first.
+         */
+        TxFrame<uint8_t> *oldestOwnFrame(Header::MessageType type)
+        {
+            TxFrame<uint8_t> *oldest = nullptr;
+            for (auto &frm : txPool)
+            {
+                if (frm.self() && frm.type() == type &&
+                    (oldest == nullptr || static_cast<int32_t>(frm.nextTx() - oldest->nextTx()) < 0))
+                {
+                    oldest = &frm;
+                }
+            }
+            return oldest;
+        }
+
+        /**
+         * @brief Find a queued frame of the application that a new frame supersedes.
+         * Only one tracking, ground tracking and service frame per destination is kept, as only the latest state
+         * is of interest. Frames that request an ack are never superseded.
+         */
+        TxFrame<uint8_t> *supersededFrame(const TxFrame<uint8_t> &txFrame)
+        {
+            auto type = txFrame.type();
+            if ((type != Header::MessageType::TRACKING && type != Header::MessageType::GROUND_TRACKING && type != Header::MessageType::SERVICE) ||
+                txFrame.ackType() != ExtendedHeader::AckType::NONE)
+            {
+                return nullptr;
+            }
+
+            for (auto &frm : txPool)
+            {
+                if (frm.self() && frm.type() == type && frm.destination() == txFrame.destination() &&
+                    frm.ackType() == ExtendedHeader::AckType::NONE)
+                {
+                    return &frm;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief Overwrite a queued frame with a newer one, the queued frame keeps its place in the schedule.
+         * @return SUPERSEDED, or POOL_FULL when the newer frame is larger and does not fit, the queued frame is kept then.
+         */
+        SendResult supersede(TxFrame<uint8_t> *queued, const TxFrame<uint8_t> &txFrame)
+        {
+            auto nextTx = queued->nextTx();
+            if (txPool.replace(queued, txFrame.data()))
+            {
+                txStatus(queued, TxStatus::DROPPED);
+                queued->id(txFrame.id()).numTx(txFrame.numTx());
+                return SendResult::SUPERSEDED;
+            }
+
+            if (!txPool.canAdd(txFrame.data().size(), queued))
+            {
+                return SendResult::POOL_FULL;
+            }
+            txStatus(queued, TxStatus::DROPPED);
+            txPool.remove(queued);
+            auto frame = txFrame;
+            frame.nextTx(nextTx);
+            return txPool.add(frame) ? SendResult::SUPERSEDED : SendResult::POOL_FULL;
+        }
+
+        static bool admitted(SendResult result)
+        {
+            return result == SendResult::ACCEPTED || result == SendResult::REPLACED || result == SendResult::SUPERSEDED;
+        }
+
+        /**
+         * @brief Add a packet of the application to the transmit pool when the admission policy allows it.
+         * The caller reports the result to the application.
+         * @param txFrame The frame to add.
+         * @param superseded A queued frame the new one takes the place of, eg the previous beacon, without further checks.
+         */
+        SendResult admit(const TxFrame<uint8_t> &txFrame, TxFrame<uint8_t> *superseded = nullptr)
+        {
+            SendResult result = SendResult::ACCEPTED;
+            if (superseded != nullptr)
+            {
+                result = supersede(superseded, txFrame);
+            }
+            else if (admissionPolicy_.rejectDuplicates && queuedDuplicate(txFrame) != nullptr)
+            {
+                result = SendResult::DUPLICATE;
+            }
+            else if (admissionPolicy_.rejectWithoutAirtime && !txFrame.isTrackingType() &&
+                     remainingAirtime(txFrame.nextTx(), dutyCycleLimits_.txPermille) == 0)
+            {
+                result = SendResult::AIRTIME_EXHAUSTED;
+            }
+            else if (auto queued = supersededFrame(txFrame))
+            {
+                result = supersede(queued, txFrame);
+            }
+            else
+            {
+                auto oldest = admissionPolicy_.replaceOldestSameType ? oldestOwnFrame(txFrame.type()) : nullptr;
+                if (oldest != nullptr && !txPool.canAdd(txFrame.data().size(), oldest))
+                {
+                    return SendResult::POOL_FULL;
+                }
+                if (oldest != nullptr)
+                {
+                    txStatus(oldest, TxStatus::DROPPED);
+                    txPool.remove(oldest);
+                    result = SendResult::REPLACED;
+                }
+                if (!txPool.add(txFrame))
+                {
+                    result = SendResult::POOL_FULL;
+                }
+            }
+
+            return result;
+        }
+
+        /**
+         * @brief Admit a packet of the application and report QUEUED or REJECTED.
+         */
+        SendResult admitOwnFrame(const TxFrame<uint8_t> &txFrame, TxFrame<uint8_t> *superseded = nullptr)
+        {
+            auto result = admit(txFrame, superseded);
+            connector->fanet_txStatus(txFrame.id(), admitted(result) ? TxStatus::QUEUED : TxStatus::REJECTED);
+            return result;
+        }
+
     public:
         /**
          * @brief Constructor for the Protocol class.
@@ -271,14 +903,61 @@ namespace FANET
          */
         Protocol(Connector *connector_) : connector(connector_)
         {
+            interfaces_.emplace_back();
+            interfaces_.back().connector = connector_;
             init();
         }
 
+        /**
+         * @brief Add a radio, eg on a second channel or with a second antenna.
+         * Frames received by all radios share the neighbor table and duplicate frames are dropped.
+         * Each frame is send once, by the radio with the most airtime left. Acks and forwards are send by the radio
+         * that received the original frame.
+         * @param connector_ The connector of the radio. Only fanet_sendFrame and fanet_channelBusy are used.
+         * @param sameChannelAs Index of a radio on the same channel, e.g. a second antenna, the two never transmit at
+         * the same time. -1 for a radio on its own channel.
+         * @return The index of the radio to pass to handleRx, or -1 when no more radios can be added.
+         */
+        int8_t addInterface(Connector *connector_, int8_t sameChannelAs = -1)
+        {
+            if (interfaces_.full())
+            {
+                return -1;
+            }
+            uint8_t channel = sameChannelAs >= 0 && static_cast<size_t>(sameChannelAs) < interfaces_.size()
+                                  ? interfaces_[sameChannelAs].channel
+                                  : static_cast<uint8_t>(interfaces_.size());
+            interfaces_.emplace_back();
+            interfaces_.back().connector = connector_;
+            interfaces_.back().channel = channel;
+            interfaces_.back().dutyCycle.window(dutyCycleLimits_.windowMs);
+            return static_cast<int8_t>(interfaces_.size() - 1);
+        }
+
+        size_t interfaceCount() const
+        {
+            return interfaces_.size();
+        }
+
         void init()
         {
             random.initialise(connector->fanet_getTick());
             neighborTable_.clear();
+            hwInfoTable_.clear();
+            trafficTable_.clear();
+            nameCache_.clear();
+            weatherTable_.clear();
+            for (auto &radio : interfaces_)
+            {
+                radio.dutyCycle.clear();
+            }
+            recentFrames_.fill(RecentFrame{});
+            for (auto &bucket : tokenBuckets_)
+            {
+                bucket.reset(connector->fanet_getTick());
+            }
             txPool.clear();
+            beacons_.clear();
         }
 
         void ownAddress(const Address &adress)
@@ -307,11 +986,146 @@ namespace FANET
         }
 
         /**
-         * @brief Get the average airtime
+         * @brief Get the last HW info received per address, e.g. to query firmware versions of devices in range
+         */
+        const HwInfoTable<FANET_MAX_HWINFO> &hwInfoTable() const
+        {
+            return hwInfoTable_;
+        }
+
+        /**
+         * @brief Get the latest state of the aircraft and ground stations in range, e.g. for a traffic display
          */
-        uint32_t airTime() const
+        TrafficTable<FANET_MAX_TRAFFIC> &trafficTable()
         {
-            return airtime.getAverage();
+            return trafficTable_;
+        }
+
+        /**
+         * @brief Get the last name received per address, e.g. to show the pilots in range
+         */
+        NameCache<FANET_MAX_NAMES, FANET_NAME_ARENA> &nameCache()
+        {
+            return nameCache_;
+        }
+
+        /**
+         * @brief Get the latest report and the statistics per weather station, e.g. to show the wind at take off
+         */
+        WeatherTable<FANET_MAX_WEATHER> &weatherTable()
+        {
+            return weatherTable_;
+        }
+
+        /**
+         * @brief Get the airtime used within the duty cycle window in per mille
+         * @param interface Index of the radio
+         */
+        uint32_t airTime(size_t interface = 0) const
+        {
+            return interfaces_[interface].dutyCycle.getAverage();
+        }
+
+        /**
+         * @brief Get the duty cycle meter, eg to query the remaining airtime budget
+         * @param interface Index of the radio
+         */
+        DutyCycle<FANET_MAX_DUTYCYCLE_RECORDS> &dutyCycle(size_t interface = 0)
+        {
+            return interfaces_[interface].dutyCycle;
+        }
+
+        const DutyCycleLimits &dutyCycleLimits() const
+        {
+            return dutyCycleLimits_;
+        }
+
+        /**
+         * @brief Set the duty cycle limits, usually taken from the current zone with findZone(lat, lon).dutyCycle
+         */
+        void dutyCycleLimits(const DutyCycleLimits &limits)
+        {
+            dutyCycleLimits_ = limits;
+            for (auto &radio : interfaces_)
+            {
+                radio.dutyCycle.window(limits.windowMs);
+            }
+        }
+
+        /**
+         * @brief Configure the airtime token bucket of a traffic class.
+         * @param trafficClass The traffic class.
+         * @param ratePermille Airtime in ms the class may use for every second.
+         * @param burstMs Maximum airtime in ms the class may use in a burst.
+         */
+        void tokenBucket(TrafficClass trafficClass, uint16_t ratePermille, uint16_t burstMs)
+        {
+            tokenBuckets_[static_cast<uint8_t>(trafficClass)].configure(ratePermille, burstMs);
+        }
+
+        const TokenBucket &tokenBucket(TrafficClass trafficClass) const
+        {
+            return tokenBuckets_[static_cast<uint8_t>(trafficClass)];
+        }
+
+        /**
+         * @brief Register a provider for a periodic beacon. The protocol asks the provider for the beacon when it is due,
+         * taking the number of neighbors and the airtime into account. The first beacon is due immediately.
+         * @param type The beacon.
+         * @param provider The provider, nullptr to stop sending the beacon.
+         */
+        void beaconProvider(BeaconType type, BeaconProvider *provider)
+        {
+            beacons_.provider(type, provider, connector->fanet_getTick());
+        }
+
+        const BeaconScheduler &beacons() const
+        {
+            return beacons_;
+        }
+
+        /**
+         * @brief Set the policy that chooses the coding rate of each frame.
+         * @param policy The policy, nullptr to choose the coding rate based on the number of neighbors only.
+         */
+        void codingRatePolicy(CodingRatePolicy *policy)
+        {
+            codingRatePolicy_ = policy;
+        }
+
+        /**
+         * @brief Get the state of the carrier sense, BACKOFF while waiting for a busy channel.
+         * @param interface Index of the radio
+         */
+        CsmaState csmaState(size_t interface = 0) const
+        {
+            return interfaces_[interface].csmaState;
+        }
+
+        /**
+         * @brief Get the queue for received frames. The radio driver fills it from an ISR or DMA callback,
+         * processRxQueue() handles the frames from task context.
+         */
+        RxQueue<FANET_RX_QUEUE_SIZE> &rxQueue()
+        {
+            return rxQueue_;
+        }
+
+        /**
+         * @brief Handle the frames in the receive queue.
+         * @param maxFrames Maximum number of frames to handle in this call.
+         * @return The number of frames handled.
+         */
+        size_t processRxQueue(size_t maxFrames = FANET_RX_QUEUE_SIZE)
+        {
+            size_t handled = 0;
+            for (auto frame = rxQueue_.front(); frame != nullptr && handled < maxFrames; frame = rxQueue_.front())
+            {
+                handleRx(frame->rssi, frame->frame(), frame->timeMs, frame->interface);
+                rxQueue_.pop();
+                handled++;
+            }
+            return handled;
         }
 
         /**
@@ -320,31 +1134,62 @@ namespace FANET
          * @tparam MAXFRAMESIZE The size of the name payload.
          * @param packet The packet to send.
          * @param id ID of this packet, can be used if you request an ack and to know if the packet was received
+         * @return If the packet was added to the transmit pool, and if not why.
          */
         template <size_t MAXFRAMESIZE>
-        void sendPacket(Packet<MAXFRAMESIZE> &packet, uint16_t id = 0, bool strict = true)
+        SendResult sendPacket(Packet<MAXFRAMESIZE> &packet, uint16_t id = 0, bool strict = true)
         {
-            uint8_t numTx;
-            if (strict)
-            {
-                // Ensure source is always our own address
-                packet.source(ownAddress_);
-                auto eh = packet.extendedHeader().value_or(ExtendedHeader{});
-                // Forward must be true when extended header has a ackType none NONE
-                if (eh.ack() != ExtendedHeader::AckType::NONE)
-                {
-                    packet.forward(true);
-                    numTx = MAC_TX_RETRANSMISSION_RETRYS;
-                }
-                else
-                {
-                    numTx = 0;
-                }
-            }
+            uint8_t numTx = strict ? ownPacket(packet) : 0;
 
             auto v = packet.build();
             auto txFrame = TxFrame<uint8_t>{{v.data(), v.size()}}.self(true).id(id).nextTx(connector->fanet_getTick()).numTx(numTx);
-            txPool.add(txFrame);
+            return admitOwnFrame(txFrame);
+        }
+
+        /**
+         * @brief Check if the transmit pool has room for a frame, eg before building a large packet.
+         * @param frameSize Size of the frame including the header.
+         */
+        bool canAccept(size_t frameSize) const
+        {
+            return txPool.canAdd(frameSize);
+        }
+
+        const AdmissionPolicy &admissionPolicy() const
+        {
+            return admissionPolicy_;
+        }
+
+        /**
+         * @brief Set how sendPacket admits packets of the application.
+         */
+        void admissionPolicy(const AdmissionPolicy &policy)
+        {
+            admissionPolicy_ = policy;
+        }
+
+        /**
+         * @brief Send a FANET packet from any task.
+         * The packet is queued without locking and added to the transmit pool by the next handleTx(),
+         * so other tasks do not need to synchronize with the task that runs the protocol.
+         * Set the own address before other tasks start submitting.
+         * @param packet The packet to send.
+         * @param id ID of this packet, can be used if you request an ack and to know if the packet was received
+         * @return false when the submission queue is full.
+         */
+        template <size_t MAXFRAMESIZE>
+        bool submitPacket(Packet<MAXFRAMESIZE> &packet, uint16_t id = 0)
+        {
+            uint8_t numTx = ownPacket(packet);
+            return txQueue_.push(packet.build(), id, numTx);
+        }
+
+        /**
+         * @brief Get the queue of packets submitted with submitPacket() that are not yet in the transmit pool.
+         */
+        const TxQueue<FANET_TX_QUEUE_SIZE> &txQueue() const
+        {
+            return txQueue_;
         }
 
         /**
@@ -356,12 +1201,26 @@ namespace FANET
          * @return The MessageType
          */
         Header::MessageType handleRx(int16_t rssddBm, etl::span<const uint8_t> buffer)
+        {
+            return handleRx(rssddBm, buffer, connector->fanet_getTick());
+        }
+
+        /**
+         * @brief Handle a received FANET packet.
+         * @param rssddBm The received signal strength in dBm.
+         * @param buffer The byte buffer containing the packet data.
+         * @param timeMs The tick when the packet was received, used for the tables. The airtime budget is checked
+         * at the current tick, as transmissions after the reception are already recorded.
+         * @param interface Index of the radio that received the packet.
+         * @return The type of the packet
+         */
+        Header::MessageType handleRx(int16_t rssddBm, etl::span<const uint8_t> buffer, uint32_t timeMs, uint8_t interface = 0)
         {
             stats_.rx++; // All packets received
+            auto nowMs = connector->fanet_getTick();
 
             // START: OK
             // static constexpr size_t MAC_PACKET_SIZE = ((MAXFRAMESIZE > MAXFRAMESIZE) ? MAXFRAMESIZE : MAXFRAMESIZE) + 12; // 12 Byte for maximum header size
-            auto timeMs = connector->fanet_getTick();
 
             auto packet = TxFrame<const uint8_t>{buffer};
             // packet.print();
@@ -370,6 +1229,7 @@ namespace FANET
 
             // fmac.283 Perhaps move this to some maintenance task?
             neighborTable_.removeOutdated(timeMs);
+            trafficTable_.expire(timeMs);
 
             // Drop packages forwarded to us
             if (packet.source() == ownAddress_)
@@ -377,14 +1237,59 @@ namespace FANET
                 stats_.rxFromUsDrp++;
                 return packet.type();
             }
+
+            // The same transmission received by another radio
+            if (interfaces_.size() > 1 && receivedByOtherInterface(buffer, timeMs, interface))
+            {
+                stats_.rxDuplicate++;
+                return packet.type();
+            }
             stats_.processed++;
 
             // fmac.322
             // addOrUpdate will guarantee this one is added, and any old one is removed
-            neighborTable_.addOrUpdate(packet.source(), timeMs);
+            neighborTable_.addOrUpdate(packet.source(), timeMs, rssddBm);
 
             stats_.neighborTableSize = neighborTable_.size();
 
+            if (packet.type() == Header::MessageType::HW_INFO && !packet.payload().empty() &&
+                packet.payload().size() >= HwInfoPayload::requiredSize(packet.payload()[0]))
+            {
+                auto payload = packet.payload();
+                etl::bit_stream_reader reader((uint8_t *)payload.data(), payload.size(), etl::endian::big);
+                hwInfoTable_.addOrUpdate(packet.source(), HwInfoPayload::deserialize(reader, payload.size()), timeMs);
+            }
+            else if (packet.type() == Header::MessageType::TRACKING && packet.payload().size() >= 11)
+            {
+                auto payload = packet.payload();
+                etl::bit_stream_reader reader((uint8_t *)payload.data(), payload.size(), etl::endian::big);
+                trafficTable_.update(packet.source(), TrackingPayload::deserialize(reader, payload.size()), timeMs);
+            }
+            else if (packet.type() == Header::MessageType::GROUND_TRACKING && packet.payload().size() >= 7)
+            {
+                auto payload = packet.payload();
+                etl::bit_stream_reader reader((uint8_t *)payload.data(), payload.size(), etl::endian::big);
+                trafficTable_.update(packet.source(), GroundTrackingPayload::deserialize(reader), timeMs);
+            }
+            else if (packet.type() == Header::MessageType::SERVICE && !packet.payload().empty() &&
+                     packet.payload().size() >= ServicePayload::requiredSize(packet.payload()[0]))
+            {
+                auto payload = packet.payload();
+                etl::bit_stream_reader reader((uint8_t *)payload.data(), payload.size(), etl::endian::big);
+                weatherTable_.update(packet.source(), ServicePayload::deserialize(reader, payload.size()), timeMs);
+            }
+            else if (packet.type() == Header::MessageType::NAME)
+            {
+                // Some devices terminate the name with zeros
+                auto payload = packet.payload();
+                auto length = payload.size();
+                while (length > 0 && payload[length - 1] == 0)
+                {
+                    length--;
+                }
+                nameCache_.update(packet.source(), etl::string_view(reinterpret_cast<const char *>(payload.data()), length));
+            }
+
             // fmac.326
             // Decide if we have seen this frame already in the past, if so decide what to do with the frame in our buffer
             // This concerns forwarding of packets from other FANET devices
@@ -414,6 +1319,9 @@ namespace FANET
                 // fmac.351
                 if ((destination == Address{} || destination == ownAddress_) && packet.source() != ownAddress_)
                 {
+                    // Before forwarding, which changes the forward bit in the buffer
+                    connector->fanet_packetReceived(PacketView{buffer}, rssddBm);
+
                     // fmac.353
                     // When we receive an ack in broadcast or to us, but the frame was not found in our pool
                     if (packet.type() == Header::MessageType::ACK)
@@ -435,7 +1343,7 @@ namespace FANET
                         {
                             // fmac.362
                             auto v = buildAck(packet);
-                            txPool.add(TxFrame<uint8_t>{v}.nextTx(timeMs));
+                            txPool.add(TxFrame<uint8_t>{v}.nextTx(timeMs).interface(interface));
                             stats_.txAck++;
                         }
                     }
@@ -450,7 +1358,8 @@ namespace FANET
                     } else if(destination != Address{} && !neighborTable_.lastSeen(destination))
                     {
                         stats_.fwdNeighborDrp++; // Packets discarded due to no neighbor in neighbor table
-                    } else if(airtime.get(timeMs) > 500) 
+                    } else if((interface < interfaces_.size() ? interfaces_[interface].dutyCycle.remaining(nowMs, dutyCycleLimits_.forwardPermille)
+                                                              : remainingAirtime(nowMs, dutyCycleLimits_.forwardPermille)) == 0)
                     {
                         stats_.fwdDropAirtime++;
                     } else
@@ -466,6 +1375,7 @@ namespace FANET
                                         .rssi(rssddBm)
                                         .numTx(numTx)
                                         .nextTx(nextTx)
+                                        .interface(interface)
                                         .forward(false);
                         txPool.add(txFrame);
                         stats_.forwarded++;
@@ -488,18 +1398,70 @@ namespace FANET
         {
             auto timeMs = connector->fanet_getTick();
 
+            processTxQueue(timeMs);
+            handleBeacons(timeMs);
+
             // fmac.403
-            if (!timeReached(timeMs, cmcaNextTx))
+            auto *next = &nextInterface(timeMs);
+            if (!timeReached(timeMs, next->cmcaNextTx))
             {
-                return cmcaNextTx;
+                return next->cmcaNextTx;
             }
 
             // Get TxFrame if available
             // fmac.417
-            auto frm = getNextTxFrame(timeMs);
+            uint32_t readyMs = timeMs + MAC_DEFAULT_TX_BACKOFF;
+            auto frm = getNextTxFrame(timeMs, readyMs);
             if (frm == nullptr)
             {
-                return timeMs + MAC_DEFAULT_TX_BACKOFF;
+                return beacons_.nextTx(timeMs, readyMs);
+            }
+
+            // fmac.446
+            // Clean up the TX queue of frames that where never acked, before they can be held back by a token bucket
+            if (frm->ackType() != ExtendedHeader::AckType::NONE && frm->numTx() == 0)
+            {
+                txStatus(frm, TxStatus::TIMED_OUT);
+                txPool.remove(frm);
+                // Recursive  to handle next frame if it's in the pool
+                return handleTx();
+            }
+
+            // Acks and forwards go out on the channel the original frame was received on,
+            // getNextTxFrame only returns them when that radio is ready
+            if (frm->interface() < interfaces_.size())
+            {
+                next = &interfaces_[frm->interface()];
+            }
+            auto &radio = *next;
+
+            // Admission control, a class that used up its airtime waits for its bucket to refill
+            // so the other classes, in particular own tracking, still get their slots
+            auto cls = trafficClass(frm);
+            auto waitMs = tokenBuckets_[static_cast<uint8_t>(cls)].timeUntil(timeMs, frameAirtime(frm));
+            if (waitMs > 0)
+            {
+                switch (cls)
+                {
+                case TrafficClass::FORWARD:
+                    stats_.fwdDropBucket++;
+                    txPool.remove(frm);
+                    break;
+                case TrafficClass::OWN_TRACKING:
+                    stats_.txDeferTracking++;
+                    frm->nextTx(timeMs + waitMs);
+                    break;
+                case TrafficClass::OWN_OTHER:
+                    stats_.txDeferOther++;
+                    frm->nextTx(timeMs + waitMs);
+                    break;
+                case TrafficClass::ACK:
+                    stats_.txDeferAck++;
+                    frm->nextTx(timeMs + waitMs);
+                    break;
+                }
+                // Recursive to handle next frame if it's in the pool
+                return handleTx();
             }
 
             // fmac.414
@@ -511,7 +1473,11 @@ namespace FANET
                 // Note: I find it odd that we set forward based on neighborTable_ table
                 bool setForward = neighborTable_.size() < MAC_MAXNEIGHBORS_4_TRACKING_2HOP;
                 frm->forward(setForward);
-                auto status = sendFrame(frm);
+                if (!channelFree(radio, timeMs))
+                {
+                    return nextInterfaceTx(timeMs);
+                }
+                auto status = sendFrame(radio, frm);
                 
                 // Update stats
                 if(status.isSend) 
@@ -523,28 +1489,16 @@ namespace FANET
                     stats_.txFailed++;
                 }
 
+                txStatus(frm, status.isSend ? TxStatus::TRANSMITTED : TxStatus::DROPPED);
                 txPool.remove(frm);
-                carrierBackoffExp = MAC_TX_BACKOFF_EXP_MIN;
-                cmcaNextTx = timeMs + MAC_TX_MINPREAMBLEHEADERTIME_MS + (status.lengthBytes * MAC_TX_TIMEPERBYTE_MS);
-                return cmcaNextTx;
+                return transmitted(radio, timeMs, status.lengthBytes);
             }
 
             // Validate if there is time for any other frames
             // fmac.428
-            auto airtimeMs = airtime.get(timeMs);
-            // printf("Air time : %dms\n", airtimeMs);
-            if (airtimeMs >= 900)
+            if (radio.dutyCycle.remaining(timeMs, dutyCycleLimits_.txPermille) == 0)
             {
-                return timeMs + MAC_DEFAULT_TX_BACKOFF;
-            }
-
-            // fmac.446
-            // Clean up the TX queue of frames that where never acked
-            if (frm->ackType() != ExtendedHeader::AckType::NONE && frm->numTx() == 0)
-            {
-                txPool.remove(frm);
-                // Recursive  to handle next frame if it's in the pool
-                return handleTx();
+                return timeMs + radio.dutyCycle.timeUntil(timeMs, dutyCycleLimits_.txPermille);
             }
 
             // fmac.457
@@ -558,8 +1512,13 @@ namespace FANET
             }
 
             /////////  Send data
+            if (!channelFree(radio, timeMs))
+            {
+                return nextInterfaceTx(timeMs);
+            }
+
             // fmac.502
-            auto status = sendFrame(frm);
+            auto status = sendFrame(radio, frm);
             timeMs = connector->fanet_getTick();
 
             // fmac 505
@@ -571,10 +1530,12 @@ namespace FANET
                 if (frm->ackType() == ExtendedHeader::AckType::NONE || frm->source() != ownAddress_)
                 {
                     // fmac.524
+                    txStatus(frm, TxStatus::TRANSMITTED);
                     txPool.remove(frm);
                 }
                 else
                 {
+                    txStatus(frm, frm->numTx() == MAC_TX_RETRANSMISSION_RETRYS ? TxStatus::TRANSMITTED : TxStatus::RETRANSMITTED);
                     // fmac.529
                     // THis will only be true when packages are send by some third party interface in fanet_cmd_state??
                     frm->numTx(frm->numTx() - 1);
@@ -590,22 +1551,13 @@ namespace FANET
                     }
                 }
 
-                carrierBackoffExp = MAC_TX_BACKOFF_EXP_MIN;
-                cmcaNextTx = timeMs + MAC_TX_MINPREAMBLEHEADERTIME_MS + (status.lengthBytes * MAC_TX_TIMEPERBYTE_MS);
-                return cmcaNextTx;
+                return transmitted(radio, timeMs, status.lengthBytes);
             }
             else
             {
                 stats_.txFailed++;
-                /* channel busy, increment backoff exp */
-                if (carrierBackoffExp < MAC_TX_BACKOFF_EXP_MAX)
-                {
-                    carrierBackoffExp++;
-                }
-
-                /* next tx try */
-                cmcaNextTx = timeMs + random.range(1 << (MAC_TX_BACKOFF_EXP_MIN - 1), 1 << carrierBackoffExp);
-                return cmcaNextTx;
+                /* channel busy, increment backoff exp and schedule the next tx try */
+                return backoff(radio, timeMs);
             }
 
             return timeMs + MAC_DEFAULT_TX_BACKOFF;
@@ -0,0 +1,408 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+#include <algorithm>
+#include "etl/vector.h"
+
+#include "address.hpp"
+#include "trafficTable.hpp"
+
+namespace FANET
+{
+    /**
+     * @brief Severity of a proximity alert, by time to the closest point of approach.
+     */
+    enum class AlertLevel : uint8_t
+    {
+        NONE = 0,
+        LOW = 1,       // Closest approach within the lookahead
+        IMPORTANT = 2, // Closest approach within importantS
+        URGENT = 3,    // Closest approach within urgentS, or already too close
+    };
+
+    /**
+     * @brief State of the own aircraft.
+     */
+    struct Ownship
+    {
+        float latitude;     // Degrees
+        float longitude;    // Degrees
+        int16_t altitude;   // Meters
+        float speed;        // km/h
+        float climbRate;    // m/s
+        float heading;      // Degrees
+        float turnRate = 0; // Degrees per second
+    };
+
+    /**
+     * @brief A target that comes too close within the lookahead.
+     */
+    struct Alert
+    {
+        Address address;
+        AlertLevel level;
+        uint32_t timeToCpaMs;  // Time until the closest point of approach
+        uint32_t cpaDistanceM; // Horizontal distance at the closest point of approach
+        int32_t cpaVerticalM;  // Altitude of the target above the own aircraft at the closest point of approach
+    };
+
+    /**
+     * @brief Limits of the proximity alerts.
+     */
+    struct AlertConfig
+    {
+        uint8_t lookaheadS = 20;     // How far tracks are predicted
+        uint8_t importantS = 13;     // Closest approach within this time is IMPORTANT
+        uint8_t urgentS = 8;         // Closest approach within this time is URGENT
+        uint16_t horizontalM = 200;  // Horizontal separation below which a target is a threat
+        uint16_t verticalM = 100;    // Vertical separation below which a target is a threat
+    };
+
+    /**
+     * @brief Predicts the tracks of the traffic and the own aircraft and reports targets that come too close.
+     *
+     * Positions are projected on a flat earth around the own aircraft, which is accurate for the range of a FANET
+     * radio, and converted once per target to decimeters. Everything after that is integer math in passes over
+     * batches of BATCH targets, each field in its own array:
+     * - straight tracks get the exact closest point of approach, in 1/32 s, with 32 bit multiplies and divides
+     * - targets with a turn rate, or all when the own aircraft turns, are stepped once per second, the velocities
+     *   rotated by the turn of one second using a Q15 sine table
+     * - the separation at the closest point of approach is compared with the limits
+     * The passes have no data dependent branches, a minimum is kept with selects, and the number of steps only
+     * depends on lookaheadS. Only the gathering of airborne targets and the alerts that are found branch.
+     * Positions are limited to MAX_POSITION_DM and speeds to MAX_SPEED_DMS so no product overflows 32 bits.
+     *
+     * @tparam MAX_ALERTS Number of alerts kept, the most severe ones win.
+     */
+    template <size_t MAX_ALERTS = 8>
+    class ProximityAlert
+    {
+        static constexpr int32_t DM_PER_DEGREE = 1111950; // Decimeters per degree latitude
+        static constexpr int32_t BINARY_ANGLE_PER_DEGREE_Q8 = 46603; // 65536 / 360 in Q8
+        static constexpr int32_t MAX_POSITION_DM = 1 << 17; // 13km, further targets are moved to this distance
+        static constexpr int32_t MAX_SPEED_DMS = 1 << 11;   // 737km/h
+        static constexpr int32_t TIME_SHIFT = 5;            // Times of the closest point of approach in 1/32 s
+        static constexpr size_t BATCH = 16;                 // Targets per pass, bounds the stack used by update()
+
+        struct Vector
+        {
+            int32_t x; // East
+            int32_t y; // North
+        };
+
+        /**
+         * @brief Airborne targets of one pass, relative to the own aircraft.
+         */
+        struct Batch
+        {
+            int32_t x[BATCH];     // East in dm
+            int32_t y[BATCH];     // North in dm
+            int32_t z[BATCH];     // Up in dm
+            int32_t vx[BATCH];    // Velocity of the target in dm/s
+            int32_t vy[BATCH];
+            int32_t climb[BATCH]; // Relative climb in dm/s
+            uint16_t turn[BATCH]; // Turn of the target per second
+            int32_t cpaTime[BATCH];
+            int64_t cpaDistance2[BATCH];
+            uint8_t slot[BATCH];
+            size_t count;
+        };
+
+        AlertConfig config_;
+        etl::vector<Alert, MAX_ALERTS> alerts_;
+
+        /**
+         * @brief Sine of an angle in 1/65536 turns in Q15, linear interpolation of a full wave table.
+         */
+        static int32_t sinQ15(uint16_t angle)
+        {
+            static constexpr int16_t WAVE[257] = {
+                0, 804, 1608, 2410, 3212, 4011, 4808, 5602, 6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+                12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530, 18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+                23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790, 27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+                30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+                32767, 32757, 32728, 32678, 32609, 32521, 32412, 32285, 32137, 31971, 31785, 31580, 31356, 31113, 30852, 30571,
+                30273, 29956, 29621, 29268, 28898, 28510, 28105, 27683, 27245, 26790, 26319, 25832, 25329, 24811, 24279, 23731,
+                23170, 22594, 22005, 21403, 20787, 20159, 19519, 18868, 18204, 17530, 16846, 16151, 15446, 14732, 14010, 13279,
+                12539, 11793, 11039, 10278, 9512, 8739, 7962, 7179, 6393, 5602, 4808, 4011, 3212, 2410, 1608, 804,
+                0, -804, -1608, -2410, -3212, -4011, -4808, -5602, -6393, -7179, -7962, -8739, -9512, -10278, -11039, -11793,
+                -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530, -18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+                -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790, -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+                -30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971, -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+                -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285, -32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+                -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683, -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+                -23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868, -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+                -12539, -11793, -11039, -10278, -9512, -8739, -7962, -7179, -6393, -5602, -4808, -4011, -3212, -2410, -1608, -804,
+                0};
+
+            uint8_t index = angle >> 8;
+            int32_t frac = angle & 0xFF;
+            int32_t a = WAVE[index];
+            int32_t b = WAVE[index + 1];
+            return a + (((b - a) * frac) >> 8);
+        }
+
+        static int32_t cosQ15(uint16_t angle)
+        {
+            return sinQ15(angle + 16384);
+        }
+
+        static uint16_t binaryAngle(float degrees)
+        {
+            return static_cast<uint16_t>(static_cast<int32_t>(degrees * (BINARY_ANGLE_PER_DEGREE_Q8 / 256.f)));
+        }
+
+        static int32_t limit(int32_t value, int32_t max)
+        {
+            return etl::min(etl::max(value, -max), max);
+        }
+
+        /**
+         * @brief Velocity in decimeters per second.
+         */
+        static Vector velocity(float speedKmh, float heading)
+        {
+            int32_t speed = limit(static_cast<int32_t>(speedKmh * (10000.f / 3600.f)), MAX_SPEED_DMS);
+            auto angle = binaryAngle(heading);
+            return Vector{(speed * sinQ15(angle)) >> 15, (speed * cosQ15(angle)) >> 15};
+        }
+
+        static Vector rotate(const Vector &v, int32_t cosTurn, int32_t sinTurn)
+        {
+            // Clockwise, as headings are
+            return Vector{(v.x * cosTurn + v.y * sinTurn) >> 15, (v.y * cosTurn - v.x * sinTurn) >> 15};
+        }
+
+        static int64_t squared(int64_t x, int64_t y)
+        {
+            return x * x + y * y;
+        }
+
+        /**
+         * @brief Closest point of approach of straight tracks, t = -(p.v) / (v.v) limited to the lookahead.
+         */
+        static void straightPass(Batch &batch, const Vector &own, int32_t lookaheadS)
+        {
+            for (size_t i = 0; i < batch.count; i++)
+            {
+                int32_t vx = batch.vx[i] - own.x;
+                int32_t vy = batch.vy[i] - own.y;
+                int32_t vv = etl::max(vx * vx + vy * vy, 1);
+                int32_t approach = etl::max(-(batch.x[i] * vx + batch.y[i] * vy), 0);
+
+                // Whole seconds, then the remainder in 1/32 s so no product needs more than 32 bits
+                int32_t seconds = etl::min(approach / vv, lookaheadS);
+                int32_t rest = seconds == lookaheadS ? 0 : approach - seconds * vv;
+                int32_t time = (seconds << TIME_SHIFT) + (rest << TIME_SHIFT) / vv;
+
+                int32_t x = batch.x[i] + ((vx * time) >> TIME_SHIFT);
+                int32_t y = batch.y[i] + ((vy * time) >> TIME_SHIFT);
+                batch.cpaTime[i] = time;
+                batch.cpaDistance2[i] = squared(x, y);
+            }
+        }
+
+        /**
+         * @brief Step turning tracks once per second, the nearest step replaces the straight result.
+         */
+        static void turnPass(Batch &batch, const Vector &ownVelocity, uint16_t ownTurn, int32_t lookaheadS)
+        {
+            // Targets to step, all of them when the own aircraft turns
+            uint8_t index[BATCH];
+            size_t count = 0;
+            for (size_t i = 0; i < batch.count; i++)
+            {
+                index[count] = static_cast<uint8_t>(i);
+                count += (ownTurn | batch.turn[i]) != 0;
+            }
+
+            int32_t x[BATCH], y[BATCH], vx[BATCH], vy[BATCH], turnCos[BATCH], turnSin[BATCH], time[BATCH];
+            int64_t distance2[BATCH];
+            for (size_t j = 0; j < count; j++)
+            {
+                auto i = index[j];
+                x[j] = batch.x[i];
+                y[j] = batch.y[i];
+                vx[j] = batch.vx[i];
+                vy[j] = batch.vy[i];
+                turnCos[j] = cosQ15(batch.turn[i]);
+                turnSin[j] = sinQ15(batch.turn[i]);
+                time[j] = 0;
+                distance2[j] = squared(x[j], y[j]);
+            }
+
+            const int32_t ownCos = cosQ15(ownTurn);
+            const int32_t ownSin = sinQ15(ownTurn);
+            Vector own = ownVelocity;
+            for (int32_t step = 1; step <= lookaheadS; step++)
+            {
+                for (size_t j = 0; j < count; j++)
+                {
+                    x[j] += vx[j] - own.x;
+                    y[j] += vy[j] - own.y;
+                    auto d2 = squared(x[j], y[j]);
+                    bool nearer = d2 < distance2[j];
+                    distance2[j] = nearer ? d2 : distance2[j];
+                    time[j] = nearer ? (step << TIME_SHIFT) : time[j];
+
+                    auto v = rotate(Vector{vx[j], vy[j]}, turnCos[j], turnSin[j]);
+                    vx[j] = v.x;
+                    vy[j] = v.y;
+                }
+                own = rotate(own, ownCos, ownSin);
+            }
+
+            for (size_t j = 0; j < count; j++)
+            {
+                batch.cpaTime[index[j]] = time[j];
+                batch.cpaDistance2[index[j]] = distance2[j];
+            }
+        }
+
+        AlertLevel levelFor(uint32_t timeToCpaMs) const
+        {
+            if (timeToCpaMs <= config_.urgentS * 1000u)
+            {
+                return AlertLevel::URGENT;
+            }
+            if (timeToCpaMs <= config_.importantS * 1000u)
+            {
+                return AlertLevel::IMPORTANT;
+            }
+            return AlertLevel::LOW;
+        }
+
+        static bool moreSevere(const Alert &a, const Alert &b)
+        {
+            return a.level != b.level ? a.level > b.level : a.timeToCpaMs < b.timeToCpaMs;
+        }
+
+        void add(const Alert &alert)
+        {
+            if (!alerts_.full())
+            {
+                alerts_.push_back(alert);
+                return;
+            }
+            auto least = std::min_element(alerts_.begin(), alerts_.end(), [](const Alert &a, const Alert &b)
+                                          { return moreSevere(b, a); });
+            if (moreSevere(alert, *least))
+            {
+                *least = alert;
+            }
+        }
+
+        /**
+         * @brief Compare the separation at the closest point of approach with the limits and keep the threats.
+         */
+        template <size_t MAX_ENTRIES>
+        void collect(const Batch &batch, const TrafficTable<MAX_ENTRIES> &traffic)
+        {
+            const int64_t horizontalDm2 = squared(config_.horizontalM * 10, 0);
+            const int32_t verticalDm = config_.verticalM * 10;
+
+            bool threat[BATCH];
+            int32_t vertical[BATCH];
+            for (size_t i = 0; i < batch.count; i++)
+            {
+                vertical[i] = batch.z[i] + ((batch.climb[i] * batch.cpaTime[i]) >> TIME_SHIFT);
+                threat[i] = (batch.cpaDistance2[i] < horizontalDm2) & (vertical[i] < verticalDm) & (vertical[i] > -verticalDm);
+            }
+
+            for (size_t i = 0; i < batch.count; i++)
+            {
+                if (threat[i])
+                {
+                    auto cpaMs = static_cast<uint32_t>((batch.cpaTime[i] * 1000) >> TIME_SHIFT);
+                    add(Alert{traffic.at(batch.slot[i]).address, levelFor(cpaMs), cpaMs,
+                              static_cast<uint32_t>(sqrtf(static_cast<float>(batch.cpaDistance2[i])) / 10), vertical[i] / 10});
+                }
+            }
+        }
+
+    public:
+        ProximityAlert(const AlertConfig &config = AlertConfig{}) : config_(config) {}
+
+        void config(const AlertConfig &config)
+        {
+            config_ = config;
+        }
+
+        const AlertConfig &config() const
+        {
+            return config_;
+        }
+
+        /**
+         * @brief Predict all airborne targets of a traffic table and collect the alerts.
+         * @param own State of the own aircraft at timeMs.
+         * @param traffic The traffic, positions are moved forward by their age.
+         * @param timeMs Current time.
+         * @return The alerts, most severe first. Valid until the next update.
+         */
+        template <size_t MAX_ENTRIES>
+        const etl::ivector<Alert> &update(const Ownship &own, const TrafficTable<MAX_ENTRIES> &traffic, uint32_t timeMs)
+        {
+            alerts_.clear();
+
+            const int32_t dmPerDegreeLon = (static_cast<int64_t>(DM_PER_DEGREE) * cosQ15(binaryAngle(own.latitude))) >> 15;
+            const int32_t lookaheadS = config_.lookaheadS;
+            const auto ownVelocity = velocity(own.speed, own.heading);
+            const int32_t ownClimb = limit(static_cast<int32_t>(own.climbRate * 10), MAX_SPEED_DMS);
+            const auto ownTurn = binaryAngle(own.turnRate);
+
+            Batch batch;
+            size_t slot = 0;
+            while (slot < traffic.size())
+            {
+                // Gather airborne targets, converted once to decimeters relative to the own aircraft
+                batch.count = 0;
+                for (; slot < traffic.size() && batch.count < BATCH; slot++)
+                {
+                    const auto target = traffic.at(slot);
+                    auto i = batch.count;
+                    float dLon = target.longitude - own.longitude;
+                    dLon = dLon > 180.f ? dLon - 360.f : (dLon < -180.f ? dLon + 360.f : dLon);
+                    auto v = velocity(target.speed, target.heading);
+                    int32_t climb = limit(static_cast<int32_t>(target.climbRate * 10), MAX_SPEED_DMS);
+
+                    // Move the last report forward to now
+                    int32_t ageMs = etl::min(etl::max(static_cast<int32_t>(timeMs - target.lastUpdate), 0), static_cast<int32_t>(TRAFFIC_MAX_AGE_MS));
+                    batch.x[i] = limit(static_cast<int32_t>(dLon * dmPerDegreeLon) + v.x * ageMs / 1000, MAX_POSITION_DM);
+                    batch.y[i] = limit(static_cast<int32_t>((target.latitude - own.latitude) * DM_PER_DEGREE) + v.y * ageMs / 1000, MAX_POSITION_DM);
+                    batch.z[i] = limit((target.altitude - own.altitude) * 10 + climb * ageMs / 1000, MAX_POSITION_DM);
+                    batch.vx[i] = v.x;
+                    batch.vy[i] = v.y;
+                    batch.climb[i] = climb - ownClimb;
+                    batch.turn[i] = binaryAngle(target.turnRate);
+                    batch.slot[i] = static_cast<uint8_t>(slot);
+                    batch.count += !target.ground;
+                }
+
+                straightPass(batch, ownVelocity, lookaheadS);
+                turnPass(batch, ownVelocity, ownTurn, lookaheadS);
+                collect(batch, traffic);
+            }
+
+            std::sort(alerts_.begin(), alerts_.end(), moreSevere);
+            return alerts_;
+        }
+
+        /**
+         * @brief Get the alerts of the last update, most severe first.
+         */
+        const etl::ivector<Alert> &alerts() const
+        {
+            return alerts_;
+        }
+
+        /**
+         * @brief Get the most severe alert level of the last update.
+         */
+        AlertLevel level() const
+        {
+            return alerts_.empty() ? AlertLevel::NONE : alerts_.front().level;
+        }
+    };
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include "etl/atomic.h"
+#include "etl/span.h"
+
+#include "header.hpp"
+
+namespace FANET
+{
+    /**
+     * @brief A frame received by the radio, waiting to be processed by the protocol.
+     */
+    struct RxFrame
+    {
+        uint8_t data[255];
+        uint8_t length;
+        int16_t rssi;      // Rssi in dBm
+        uint32_t timeMs;   // Tick when the frame was received
+        uint8_t interface; // Index of the radio that received the frame
+
+        etl::span<const uint8_t> frame() const
+        {
+            return etl::span<const uint8_t>(data, length);
+        }
+    };
+
+    /**
+     * @brief Lock free single producer single consumer queue of received frames.
+     *
+     * The producer, typically the radio ISR or DMA callback, writes the frame directly into a free slot with
+     * acquire() and commit(), or copies it with push(). The consumer, Protocol::processRxQueue() in task context,
+     * handles the frame from the slot it was written to, so a frame is copied exactly once.
+     * Only the producer changes writeIndex and only the consumer changes readIndex.
+     *
+     * @tparam SIZE Number of frames, must be a power of two.
+     */
+    template <size_t SIZE>
+    class RxQueue
+    {
+        static_assert(SIZE > 0 && (SIZE & (SIZE - 1)) == 0, "SIZE must be a power of two");
+
+        RxFrame frames[SIZE];
+        etl::atomic<uint32_t> writeIndex{0};
+        etl::atomic<uint32_t> readIndex{0};
+        etl::atomic<uint32_t> dropped_{0};
+
+    public:
+        /**
+         * @brief Producer, get the next free slot to write a frame into.
+         * @return The slot, or nullptr when the queue is full. The frame is counted as dropped.
+         */
+        RxFrame *acquire()
+        {
+            auto write = writeIndex.load(etl::memory_order_relaxed);
+            if (write - readIndex.load(etl::memory_order_acquire) >= SIZE)
+            {
+                dropped_.store(dropped_.load(etl::memory_order_relaxed) + 1, etl::memory_order_relaxed);
+                return nullptr;
+            }
+            return &frames[write % SIZE];
+        }
+
+        /**
+         * @brief Producer, publish the slot returned by acquire() to the consumer.
+         * @param length Number of bytes written into the slot.
+         * @param rssi Rssi of the frame in dBm.
+         * @param timeMs Tick when the frame was received.
+         * @param interface Index of the radio that received the frame.
+         */
+        void commit(uint8_t length, int16_t rssi, uint32_t timeMs, uint8_t interface = 0)
+        {
+            auto write = writeIndex.load(etl::memory_order_relaxed);
+            auto &frame = frames[write % SIZE];
+            frame.length = length;
+            frame.rssi = rssi;
+            frame.timeMs = timeMs;
+            frame.interface = interface;
+            writeIndex.store(write + 1, etl::memory_order_release);
+        }
+
+        /**
+         * @brief Producer, copy a frame into the queue.
+         * @return false when the queue is full or the frame is too long.
+         */
+        bool push(etl::span<const uint8_t> data, int16_t rssi, uint32_t timeMs, uint8_t interface = 0)
+        {
+            if (data.size() > sizeof(RxFrame::data))
+            {
+                return false;
+            }
+            auto frame = acquire();
+            if (frame == nullptr)
+            {
+                return false;
+            }
+            std::copy(data.begin(), data.end(), frame->data);
+            commit(static_cast<uint8_t>(data.size()), rssi, timeMs, interface);
+            return true;
+        }
+
+        /**
+         * @brief Consumer, get the oldest frame.
+         * @return The frame, or nullptr when the queue is empty.
+         */
+        const RxFrame *front() const
+        {
+            auto read = readIndex.load(etl::memory_order_relaxed);
+            if (writeIndex.load(etl::memory_order_acquire) == read)
+            {
+                return nullptr;
+            }
+            return &frames[read % SIZE];
+        }
+
+        /**
+         * @brief Consumer, release the frame returned by front() so the slot can be reused.
+         */
+        void pop()
+        {
+            readIndex.store(readIndex.load(etl::memory_order_relaxed) + 1, etl::memory_order_release);
+        }
+
+        size_t size() const
+        {
+            return writeIndex.load(etl::memory_order_acquire) - readIndex.load(etl::memory_order_acquire);
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        /**
+         * @brief Number of frames that did not fit in the queue.
+         */
+        uint32_t dropped() const
+        {
+            return dropped_.load(etl::memory_order_relaxed);
+        }
+    };
+}
@@ -151,7 +151,7 @@ namespace FANET
          * @brief get the temperature in degrees
          * @param The temperature
          */
-        float temperature()
+        float temperature() const
         {
             return temperatureRaw / 2.f;
         }
@@ -332,6 +332,22 @@ namespace FANET
             }
         }
 
+        /**
+         * @brief Get the number of bytes of a payload with this header byte.
+         * @param header The first byte of the payload.
+         */
+        static size_t requiredSize(uint8_t header)
+        {
+            size_t size = (header & 0x01) ? 2 : 1;
+            size += (header & 0b01111011) ? 6 : 0; // Position
+            size += (header & 0x40) ? 1 : 0;       // Temperature
+            size += (header & 0x20) ? 3 : 0;       // Wind
+            size += (header & 0x10) ? 1 : 0;       // Humidity
+            size += (header & 0x08) ? 2 : 0;       // Barometric
+            size += (header & 0x02) ? 1 : 0;       // Battery
+            return size;
+        }
+
         /**
          * @brief Deserialize the service payload from a bit stream.
          * @param reader The bit stream reader.
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <stdint.h>
+#include "etl/algorithm.h"
+
+namespace FANET
+{
+    /**
+     * @brief Traffic classes that each have their own airtime token bucket.
+     */
+    enum class TrafficClass : uint8_t
+    {
+        OWN_TRACKING = 0, // Own tracking and ground tracking frames
+        OWN_OTHER = 1,    // All other frames of the application, eg name, message and service
+        ACK = 2,          // Acknowledgements
+        FORWARD = 3,      // Frames received from others that are forwarded
+    };
+
+    static constexpr size_t TRAFFIC_CLASS_COUNT = 4;
+
+    /**
+     * @brief Token bucket where tokens are milliseconds of airtime.
+     *
+     * The bucket is refilled with ratePermille ms of airtime for every second that passes, up to burstMs.
+     * A frame can be sent when the bucket holds at least its airtime. Frames with an airtime larger than the
+     * burst size are allowed on a full bucket so they cannot block a class forever.
+     * Tokens are kept in 1/1000 ms so slow rates do not lose tokens to rounding.
+     */
+    class TokenBucket
+    {
+        uint32_t tokens;
+        uint32_t lastRefill = 0;
+        uint16_t ratePermille;
+        uint16_t burstMs;
+
+        void refill(uint32_t currentTimeMs)
+        {
+            // A time before the last refill, e.g. of a frame received earlier, adds nothing
+            if (static_cast<int32_t>(currentTimeMs - lastRefill) <= 0)
+            {
+                return;
+            }
+            uint64_t added = static_cast<uint64_t>(currentTimeMs - lastRefill) * ratePermille;
+            tokens = etl::min<uint64_t>(tokens + added, capacity());
+            lastRefill = currentTimeMs;
+        }
+
+        uint32_t capacity() const
+        {
+            return static_cast<uint32_t>(burstMs) * 1000;
+        }
+
+        uint32_t cost(uint16_t airtimeMs) const
+        {
+            return static_cast<uint32_t>(etl::min(airtimeMs, burstMs)) * 1000;
+        }
+
+    public:
+        /**
+         * @param ratePermille Airtime in ms added for every second, at least 1.
+         * @param burstMs Maximum airtime in ms that can be sent in a burst.
+         */
+        TokenBucket(uint16_t ratePermille = 1000, uint16_t burstMs = 1000)
+            : tokens(static_cast<uint32_t>(burstMs) * 1000), ratePermille(etl::max<uint16_t>(ratePermille, 1)), burstMs(burstMs) {}
+
+        /**
+         * @brief Change rate and burst size, the bucket is filled.
+         */
+        void configure(uint16_t newRatePermille, uint16_t newBurstMs)
+        {
+            ratePermille = etl::max<uint16_t>(newRatePermille, 1);
+            burstMs = newBurstMs;
+            tokens = capacity();
+        }
+
+        /**
+         * @brief Fill the bucket.
+         */
+        void reset(uint32_t currentTimeMs)
+        {
+            tokens = capacity();
+            lastRefill = currentTimeMs;
+        }
+
+        uint16_t rate() const
+        {
+            return ratePermille;
+        }
+
+        uint16_t burst() const
+        {
+            return burstMs;
+        }
+
+        /**
+         * @brief Get the airtime in ms available for sending.
+         */
+        uint32_t available(uint32_t currentTimeMs)
+        {
+            refill(currentTimeMs);
+            return tokens / 1000;
+        }
+
+        /**
+         * @brief Get the time until a frame with airtimeMs can be sent.
+         * @return 0 when the frame can be sent now.
+         */
+        uint32_t timeUntil(uint32_t currentTimeMs, uint16_t airtimeMs)
+        {
+            refill(currentTimeMs);
+            auto needed = cost(airtimeMs);
+            if (tokens >= needed)
+            {
+                return 0;
+            }
+            return (needed - tokens + ratePermille - 1) / ratePermille;
+        }
+
+        /**
+         * @brief Take the airtime of a sent frame from the bucket.
+         * The bucket never goes below empty, so a frame sent without checking does not delay the class longer than a full refill.
+         * @return True when enough tokens were available.
+         */
+        bool consume(uint32_t currentTimeMs, uint16_t airtimeMs)
+        {
+            refill(currentTimeMs);
+            auto needed = cost(airtimeMs);
+            if (tokens >= needed)
+            {
+                tokens -= needed;
+                return true;
+            }
+            tokens = 0;
+            return false;
+        }
+    };
+}
@@ -41,6 +41,9 @@ namespace FANET
         bool tScalingBit = false;
         int8_t turnRateRaw = 0;
         bool hasTurnRateRaw = false;
+        bool qScalingBit = false;
+        int8_t qneOffsetRaw = 0;
+        bool hasQneOffsetRaw = false;
 
     public:
         /**
@@ -321,6 +324,48 @@ namespace FANET
             return *this;
         }
 
+        /**
+         * @brief Check if the QNE offset is set.
+         * @return True if the QNE offset is set, false otherwise.
+         */
+        bool hasQneOffset() const
+        {
+            return hasQneOffsetRaw;
+        }
+
+        /**
+         * @brief Get the QNE offset (QNE - GPS altitude) in meters.
+         * @return The QNE offset in meters.
+         */
+        int16_t qneOffset() const
+        {
+            return qScalingBit ? qneOffsetRaw * 4 : qneOffsetRaw;
+        }
+
+        /**
+         * @brief Set the QNE offset (QNE - GPS altitude) in meters.
+         * When set, the turn rate byte is always send as well
+         * @param qneOffset The QNE offset in meters.
+         * @return Reference to the current object.
+         */
+        TrackingPayload &qneOffset(int16_t qneOffset)
+        {
+            hasQneOffsetRaw = true;
+            int16_t qneOs = etl::clamp(static_cast<int>(qneOffset), -252, 252); // 63 * 4, largest value that fits in 7 bits
+            if (etl::absolute(qneOs) > 63)
+            {
+                qneOffsetRaw = ((qneOs + (qneOs >= 0 ? 2 : -2)) / 4);
+                qScalingBit = true;
+            }
+            else
+            {
+                qneOffsetRaw = qneOs;
+                qScalingBit = false;
+            }
+
+            return *this;
+        }
+
         /**
          * @brief Serialize the tracking payload to a bit stream.
          * @param writer The bit stream writer.
@@ -344,21 +389,33 @@ namespace FANET
 
             writer.write_unchecked(groundTrackRaw, 8U);
 
-            if (hasTurnRateRaw)
+            // The turn rate is mandatory when the QNE offset is used
+            if (hasTurnRateRaw || hasQneOffsetRaw)
             {
                 writer.write_unchecked(tScalingBit);
                 writer.write_unchecked(turnRateRaw, 7U);
             }
+
+            if (hasQneOffsetRaw)
+            {
+                writer.write_unchecked(qScalingBit);
+                writer.write_unchecked(qneOffsetRaw, 7U);
+            }
         }
 
         /**
          * @brief Deserialize the tracking payload from a bit stream.
+         * The optional turn rate and QNE offset are detected from the payload size.
          * @param reader The bit stream reader.
+         * @param payloadSize The size of the payload in bytes.
          * @return The deserialized tracking payload.
          */
-        static const TrackingPayload deserialize(etl::bit_stream_reader &reader)
+        static const TrackingPayload deserialize(etl::bit_stream_reader &reader, size_t payloadSize)
         {
             TrackingPayload tracking;
+            tracking.hasTurnRateRaw = payloadSize >= 12;
+            tracking.hasQneOffsetRaw = payloadSize >= 13;
+
             tracking.latitudeRaw = etl::reverse_bytes(reader.read_unchecked<uint32_t>(24U)) >> 8;
             tracking.longitudeRaw = etl::reverse_bytes(reader.read_unchecked<uint32_t>(24U)) >> 8;
 
@@ -378,13 +435,18 @@ namespace FANET
 
             tracking.groundTrackRaw = reader.read_unchecked<uint8_t>(8U);
 
-            auto tScaling = reader.read<bool>();
-            if (tScaling)
+            if (tracking.hasTurnRateRaw)
             {
-                tracking.tScalingBit = tScaling.value();
+                tracking.tScalingBit = reader.read_unchecked<bool>();
                 tracking.turnRateRaw = reader.read_unchecked<int8_t>(7U);
             }
 
+            if (tracking.hasQneOffsetRaw)
+            {
+                tracking.qScalingBit = reader.read_unchecked<bool>();
+                tracking.qneOffsetRaw = reader.read_unchecked<int8_t>(7U);
+            }
+
             return tracking;
         }
     };
@@ -0,0 +1,410 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+#include "etl/algorithm.h"
+#include "etl/optional.h"
+#include "etl/span.h"
+
+#include "address.hpp"
+#include "addressIndex.hpp"
+#include "tracking.hpp"
+#include "groundTracking.hpp"
+
+namespace FANET
+{
+    static constexpr uint32_t TRAFFIC_MAX_AGE_MS = 60 * 1000;      // Aircraft not heard of for 1min are removed
+    static constexpr uint32_t DEAD_RECKONING_MAX_MS = 20 * 1000; // Positions are not predicted further than 20s
+
+    /**
+     * @brief Latest known state of an aircraft or ground station.
+     */
+    struct Aircraft
+    {
+        Address address;
+        float latitude;    // Degrees
+        float longitude;   // Degrees
+        int16_t altitude;  // Meters, 0 for ground tracking
+        float speed;       // km/h, 0 for ground tracking
+        float climbRate;   // m/s, 0 for ground tracking
+        float heading;     // Degrees, 0 for ground tracking
+        float turnRate;    // Degrees per second, 0 when not send
+        bool ground;       // State from a ground tracking frame
+        uint8_t type;      // TrackingPayload::AircraftType, or GroundTrackingPayload::TrackingType when ground is set
+        uint32_t lastUpdate;
+    };
+
+    /**
+     * @brief Bounded table of the latest state per address, decoded from tracking and ground tracking frames.
+     *
+     * Each field is stored in its own array, so expiry and distance sorting only touch the fields they need.
+     * Addresses are found through an AddressIndex, removal keeps the arrays dense by moving the last entry into
+     * the free slot.
+     * When the table is full the entry that was updated the longest time ago is replaced.
+     *
+     * @tparam MAX_ENTRIES Number of aircraft, at most 127.
+     */
+    template <size_t MAX_ENTRIES>
+    class TrafficTable
+    {
+        static_assert(MAX_ENTRIES > 0 && MAX_ENTRIES <= 127, "MAX_ENTRIES must be between 1 and 127");
+
+        using Index = AddressIndex<MAX_ENTRIES, uint8_t>;
+        static constexpr uint8_t EMPTY = Index::EMPTY;
+        static constexpr float METERS_PER_DEGREE = 111195.f;
+        static constexpr float DEGREES_TO_RAD = 0.01745329f;
+        static constexpr float QUARTER_TURN = 1.5707963f;
+
+        Address address_[MAX_ENTRIES];
+        float latitude_[MAX_ENTRIES];
+        float longitude_[MAX_ENTRIES];
+        int16_t altitude_[MAX_ENTRIES];
+        float speed_[MAX_ENTRIES];
+        float climbRate_[MAX_ENTRIES];
+        float heading_[MAX_ENTRIES];
+        float turnRate_[MAX_ENTRIES];
+        bool ground_[MAX_ENTRIES];
+        uint8_t type_[MAX_ENTRIES];
+        uint32_t lastUpdate_[MAX_ENTRIES];
+
+        // Derived by the first predict() after an update, so updates do not pay for the trigonometry
+        mutable float cosHeading_[MAX_ENTRIES];
+        mutable float sinHeading_[MAX_ENTRIES];
+        mutable float turnRad_[MAX_ENTRIES];      // Turn rate in rad/s
+        mutable float turnTime_[MAX_ENTRIES];     // Time in s until a quarter turn is done
+        mutable float degreesPerMeterLon_[MAX_ENTRIES];
+        mutable bool derived_[MAX_ENTRIES];
+
+        float distance_[MAX_ENTRIES];
+        uint8_t order_[MAX_ENTRIES];
+        uint8_t sorted_ = 0; // Number of slots in order_
+
+        Index index_;
+        uint8_t size_ = 0;
+
+        size_t position(const Address &address) const
+        {
+            return index_.position(address, [this](uint8_t slot) -> const Address &
+                                   { return address_[slot]; });
+        }
+
+        void removeSlot(uint8_t slot)
+        {
+            index_.unlink(position(address_[slot]), [this](uint8_t slot) -> const Address &
+                          { return address_[slot]; });
+
+            uint8_t last = size_ - 1;
+            if (slot != last)
+            {
+                index_[position(address_[last])] = slot;
+                address_[slot] = address_[last];
+                latitude_[slot] = latitude_[last];
+                longitude_[slot] = longitude_[last];
+                altitude_[slot] = altitude_[last];
+                speed_[slot] = speed_[last];
+                climbRate_[slot] = climbRate_[last];
+                heading_[slot] = heading_[last];
+                turnRate_[slot] = turnRate_[last];
+                ground_[slot] = ground_[last];
+                type_[slot] = type_[last];
+                lastUpdate_[slot] = lastUpdate_[last];
+                cosHeading_[slot] = cosHeading_[last];
+                sinHeading_[slot] = sinHeading_[last];
+                turnRad_[slot] = turnRad_[last];
+                turnTime_[slot] = turnTime_[last];
+                degreesPerMeterLon_[slot] = degreesPerMeterLon_[last];
+                derived_[slot] = derived_[last];
+            }
+            size_--;
+        }
+
+        void motion(size_t slot) const
+        {
+            float heading = heading_[slot] * DEGREES_TO_RAD;
+            cosHeading_[slot] = cosf(heading);
+            sinHeading_[slot] = sinf(heading);
+            turnRad_[slot] = turnRate_[slot] * DEGREES_TO_RAD;
+            turnTime_[slot] = turnRad_[slot] != 0 ? QUARTER_TURN / fabsf(turnRad_[slot]) : DEAD_RECKONING_MAX_MS / 1000.f;
+            degreesPerMeterLon_[slot] = 1.f / (METERS_PER_DEGREE * cosf(latitude_[slot] * DEGREES_TO_RAD));
+            derived_[slot] = true;
+        }
+
+        /**
+         * @brief Get the slot of an address, a new slot when it is not in the table.
+         */
+        uint8_t slotFor(const Address &address)
+        {
+            auto pos = position(address);
+            if (index_[pos] != EMPTY)
+            {
+                return index_[pos];
+            }
+
+            if (size_ == MAX_ENTRIES)
+            {
+                uint8_t oldest = 0;
+                for (uint8_t i = 1; i < size_; i++)
+                {
+                    if (static_cast<int32_t>(lastUpdate_[i] - lastUpdate_[oldest]) < 0)
+                    {
+                        oldest = i;
+                    }
+                }
+                removeSlot(oldest);
+                pos = position(address);
+            }
+
+            uint8_t slot = size_++;
+            index_[pos] = slot;
+            address_[slot] = address;
+            return slot;
+        }
+
+    public:
+        TrafficTable()
+        {
+            clear();
+        }
+
+        void clear()
+        {
+            size_ = 0;
+            sorted_ = 0;
+            index_.clear();
+        }
+
+        size_t size() const
+        {
+            return size_;
+        }
+
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        /**
+         * @brief Add or update the state of an aircraft from a tracking frame.
+         * @param address The source address of the frame.
+         * @param tracking The received tracking payload.
+         * @param timeMs Time the frame was received.
+         */
+        void update(const Address &address, const TrackingPayload &tracking, uint32_t timeMs)
+        {
+            auto slot = slotFor(address);
+            latitude_[slot] = tracking.latitude();
+            longitude_[slot] = tracking.longitude();
+            altitude_[slot] = tracking.altitude();
+            speed_[slot] = tracking.speed();
+            climbRate_[slot] = tracking.climbRate();
+            heading_[slot] = tracking.groundTrack();
+            turnRate_[slot] = tracking.hasTurnrate() ? tracking.turnRate() : 0;
+            ground_[slot] = false;
+            type_[slot] = static_cast<uint8_t>(tracking.aircraftType());
+            lastUpdate_[slot] = timeMs;
+            derived_[slot] = false;
+        }
+
+        /**
+         * @brief Add or update the state of an address from a ground tracking frame.
+         * @param address The source address of the frame.
+         * @param tracking The received ground tracking payload.
+         * @param timeMs Time the frame was received.
+         */
+        void update(const Address &address, const GroundTrackingPayload &tracking, uint32_t timeMs)
+        {
+            auto slot = slotFor(address);
+            latitude_[slot] = tracking.latitude();
+            longitude_[slot] = tracking.longitude();
+            altitude_[slot] = 0;
+            speed_[slot] = 0;
+            climbRate_[slot] = 0;
+            heading_[slot] = 0;
+            turnRate_[slot] = 0;
+            ground_[slot] = true;
+            type_[slot] = tracking.groundType().get_value();
+            lastUpdate_[slot] = timeMs;
+            derived_[slot] = false;
+        }
+
+        /**
+         * @brief Get the state of an address.
+         * @return The state, or no value when nothing was received from this address.
+         */
+        etl::optional<Aircraft> find(const Address &address) const
+        {
+            auto slot = index_[position(address)];
+            if (slot == EMPTY)
+            {
+                return etl::nullopt;
+            }
+            return at(slot);
+        }
+
+        bool contains(const Address &address) const
+        {
+            return index_[position(address)] != EMPTY;
+        }
+
+        void remove(const Address &address)
+        {
+            auto slot = index_[position(address)];
+            if (slot != EMPTY)
+            {
+                removeSlot(slot);
+            }
+        }
+
+        /**
+         * @brief Remove all entries that were not updated within maxAgeMs.
+         * @param timeMs Current time.
+         * @param maxAgeMs Maximum age of an entry.
+         */
+        void expire(uint32_t timeMs, uint32_t maxAgeMs = TRAFFIC_MAX_AGE_MS)
+        {
+            uint8_t slot = 0;
+            while (slot < size_)
+            {
+                if (static_cast<int32_t>(timeMs - lastUpdate_[slot]) > static_cast<int32_t>(maxAgeMs))
+                {
+                    // The last entry moves into this slot, check it again
+                    removeSlot(slot);
+                }
+                else
+                {
+                    slot++;
+                }
+            }
+        }
+
+        /**
+         * @brief Get the state in a slot, slots are 0 up to size() - 1.
+         */
+        Aircraft at(size_t slot) const
+        {
+            return Aircraft{address_[slot], latitude_[slot], longitude_[slot], altitude_[slot], speed_[slot],
+                            climbRate_[slot], heading_[slot], turnRate_[slot], ground_[slot], type_[slot], lastUpdate_[slot]};
+        }
+
+        /**
+         * @brief Sort the slots by distance to a position.
+         * Uses a flat earth approximation, accurate enough for the range of a FANET radio.
+         * The order of the previous call is the starting point, so while the traffic moves slowly it is almost sorted.
+         * @param latitude Latitude of the position in degrees.
+         * @param longitude Longitude of the position in degrees.
+         * @return The slots, nearest first. Valid until the table changes.
+         */
+        etl::span<const uint8_t> byDistance(float latitude, float longitude)
+        {
+            float cosLatitude = cosf(latitude * DEGREES_TO_RAD);
+            for (uint8_t slot = 0; slot < size_; slot++)
+            {
+                float dLon = longitude_[slot] - longitude;
+                if (dLon > 180.f)
+                {
+                    dLon -= 360.f;
+                }
+                else if (dLon < -180.f)
+                {
+                    dLon += 360.f;
+                }
+                float x = dLon * cosLatitude * METERS_PER_DEGREE;
+                float y = (latitude_[slot] - latitude) * METERS_PER_DEGREE;
+                distance_[slot] = sqrtf(x * x + y * y);
+            }
+
+            // Keep the previous order of slots that still exist and append new slots
+            uint8_t count = 0;
+            for (uint8_t i = 0; i < sorted_; i++)
+            {
+                if (order_[i] < size_)
+                {
+                    order_[count++] = order_[i];
+                }
+            }
+            for (uint8_t slot = count; slot < size_; slot++)
+            {
+                order_[count++] = slot;
+            }
+
+            // Insertion sort, linear for an almost sorted order
+            for (uint8_t i = 1; i < size_; i++)
+            {
+                auto slot = order_[i];
+                auto j = i;
+                while (j > 0 && distance_[order_[j - 1]] > distance_[slot])
+                {
+                    order_[j] = order_[j - 1];
+                    j--;
+                }
+                order_[j] = slot;
+            }
+            sorted_ = size_;
+
+            return etl::span<const uint8_t>(order_, size_);
+        }
+
+        /**
+         * @brief Estimate the current position of all entries from their last speed, heading, climb and turn rate.
+         *
+         * The turn is followed for at most a quarter turn, after that the track continues straight. The arc uses
+         * polynomials of the turn angle instead of trigonometric functions and there are no branches, so the loop
+         * over the slots can be vectorised by the compiler. Heading and latitude terms of entries updated since the
+         * last call are calculated first.
+         * @param timeMs Current time.
+         * @param latitude Predicted latitude in degrees per slot.
+         * @param longitude Predicted longitude in degrees per slot.
+         * @param altitude Predicted altitude in meters per slot.
+         * @param maxMs Reports are not predicted further than this.
+         * @return Number of slots written, the smallest of size() and the output sizes.
+         */
+        size_t predict(uint32_t timeMs, etl::span<float> latitude, etl::span<float> longitude, etl::span<float> altitude,
+                       uint32_t maxMs = DEAD_RECKONING_MAX_MS) const
+        {
+            size_t count = etl::min(etl::min(static_cast<size_t>(size_), latitude.size()), etl::min(longitude.size(), altitude.size()));
+            const float maxS = maxMs / 1000.f;
+            for (size_t slot = 0; slot < count; slot++)
+            {
+                if (!derived_[slot])
+                {
+                    motion(slot);
+                }
+            }
+
+            for (size_t slot = 0; slot < count; slot++)
+            {
+                float t = etl::min(etl::max(static_cast<int32_t>(timeMs - lastUpdate_[slot]) / 1000.f, 0.f), maxS);
+                float speed = speed_[slot] * (1.f / 3.6f);
+
+                // Time turning, then straight along the new heading
+                float turning = etl::min(t, turnTime_[slot]);
+                float straight = t - turning;
+                float a = turnRad_[slot] * turning;
+                float a2 = a * a;
+                float sinA = a * (1.f - a2 * (1.f / 6.f - a2 * (1.f / 120.f)));
+                float cosA = 1.f - a2 * (0.5f - a2 * (1.f / 24.f - a2 * (1.f / 720.f)));
+                // sin(a) / turn rate and (1 - cos(a)) / turn rate
+                float arcAlong = turning * (1.f - a2 * (1.f / 6.f - a2 * (1.f / 120.f)));
+                float arcAcross = turning * a * (0.5f - a2 * (1.f / 24.f - a2 * (1.f / 720.f)));
+
+                float along = speed * (arcAlong + straight * cosA);
+                float across = speed * (arcAcross + straight * sinA);
+                float north = along * cosHeading_[slot] - across * sinHeading_[slot];
+                float east = along * sinHeading_[slot] + across * cosHeading_[slot];
+
+                latitude[slot] = latitude_[slot] + north * (1.f / METERS_PER_DEGREE);
+                longitude[slot] = longitude_[slot] + east * degreesPerMeterLon_[slot];
+                altitude[slot] = altitude_[slot] + climbRate_[slot] * t;
+            }
+            return count;
+        }
+
+        /**
+         * @brief Get the distance in meters of a slot, as calculated by the last byDistance().
+         */
+        float distance(size_t slot) const
+        {
+            return distance_[slot];
+        }
+    };
+}
@@ -18,6 +18,7 @@ namespace FANET
     {
         friend class Protocol;
         friend class BlockAllocator;
+        friend class PacketView;
 
     private:
         static_assert(std::is_same_v<T, uint8_t> || std::is_same_v<T, const uint8_t>,
@@ -32,12 +33,13 @@ namespace FANET
             int8_t rssi_;              // Received Signal Strength Indicator (RSSI)
         } __attribute__((__packed__)); // Ensure no padding is added to the struct
         uint16_t id_;                  // An app can give a packet an ID. During callbacks the same ID will be returned to indicate that a packet was acked/received etc.
+        uint8_t interface_;            // Radio the frame must be send on, ANY_INTERFACE for the radio with the most airtime left
 
         /**
          * @brief Constructor that initializes the TxFrame with a block of data.
          * @param block The block of data.
          */
-        TxFrame(etl::span<T> block) : block_(block), nextTx_(0), numTx_(0), self_(false), rssi_(0), id_(0) {}
+        TxFrame(etl::span<T> block) : block_(block), nextTx_(0), numTx_(0), self_(false), rssi_(0), id_(0), interface_(ANY_INTERFACE) {}
 
         /**
          * @brief Set the number of transmissions.
@@ -68,6 +70,17 @@ namespace FANET
             return *this;
         }
 
+        /**
+         * @brief Bind the frame to a radio, e.g. acks and forwards to the radio that received the original frame.
+         * @param v Index of the radio, ANY_INTERFACE for the radio with the most airtime left.
+         * @return Reference to the current object.
+         */
+        TxFrame &interface(uint8_t v)
+        {
+            interface_ = v;
+            return *this;
+        }
+
         /**
          * @brief Set the RSSI value.
          * @param v The RSSI value.
@@ -134,6 +147,8 @@ namespace FANET
         }
 
     public:
+        static constexpr uint8_t ANY_INTERFACE = 0xFF;
+
         /**
          * @brief Get the next transmission time.
          * @return The next transmission time.
@@ -161,6 +176,15 @@ namespace FANET
             return numTx_;
         }
 
+        /**
+         * @brief Get the radio the frame must be send on.
+         * @return Index of the radio, ANY_INTERFACE when any radio can send it.
+         */
+        uint8_t interface() const
+        {
+            return interface_;
+        }
+
         /**
          * @brief Get the RSSI value.
          * @return The RSSI value.
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include "etl/atomic.h"
+#include "etl/span.h"
+
+namespace FANET
+{
+    /**
+     * @brief A frame submitted by the application, waiting to be added to the transmit pool.
+     */
+    struct TxSubmission
+    {
+        uint8_t data[255];
+        uint8_t length;
+        uint8_t numTx; // Number of retransmissions
+        uint16_t id;   // ID of the packet given by the application
+
+        etl::span<const uint8_t> frame() const
+        {
+            return etl::span<const uint8_t>(data, length);
+        }
+    };
+
+    /**
+     * @brief Lock free multiple producer single consumer queue of frames to send.
+     *
+     * Any task can push() a frame, the protocol takes them from the queue in handleTx().
+     * Each slot has a sequence number that tells if it is free for the producer of a given position
+     * or filled for the consumer, producers only compete for the write position with a compare and swap.
+     *
+     * @tparam SIZE Number of frames, must be a power of two.
+     */
+    template <size_t SIZE>
+    class TxQueue
+    {
+        static_assert(SIZE > 0 && (SIZE & (SIZE - 1)) == 0, "SIZE must be a power of two");
+
+        struct Slot
+        {
+            etl::atomic<uint32_t> sequence;
+            TxSubmission submission;
+        };
+
+        Slot slots[SIZE];
+        etl::atomic<uint32_t> writeIndex{0};
+        etl::atomic<uint32_t> readIndex{0};
+        etl::atomic<uint32_t> dropped_{0};
+
+    public:
+        TxQueue()
+        {
+            for (uint32_t i = 0; i < SIZE; i++)
+            {
+                slots[i].sequence.store(i, etl::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Producer, copy a frame into the queue. Can be called from any task.
+         * @param data The frame.
+         * @param id ID of the packet.
+         * @param numTx Number of retransmissions.
+         * @return false when the queue is full or the frame is too long. A full queue is counted as dropped.
+         */
+        bool push(etl::span<const uint8_t> data, uint16_t id, uint8_t numTx)
+        {
+            if (data.size() > sizeof(TxSubmission::data))
+            {
+                return false;
+            }
+
+            auto write = writeIndex.load(etl::memory_order_relaxed);
+            Slot *slot;
+            while (true)
+            {
+                slot = &slots[write % SIZE];
+                auto diff = static_cast<int32_t>(slot->sequence.load(etl::memory_order_acquire) - write);
+                if (diff == 0)
+                {
+                    // Slot is free for this position, claim it
+                    if (writeIndex.compare_exchange_weak(write, write + 1, etl::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // Slot still holds a frame from the previous round
+                    dropped_.fetch_add(1, etl::memory_order_relaxed);
+                    return false;
+                }
+                else
+                {
+                    // Another producer claimed this position
+                    write = writeIndex.load(etl::memory_order_relaxed);
+                }
+            }
+
+            std::copy(data.begin(), data.end(), slot->submission.data);
+            slot->submission.length = static_cast<uint8_t>(data.size());
+            slot->submission.id = id;
+            slot->submission.numTx = numTx;
+            slot->sequence.store(write + 1, etl::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Consumer, get the oldest frame.
+         * @return The frame, or nullptr when the queue is empty or the oldest frame is still being written.
+         */
+        const TxSubmission *front() const
+        {
+            auto read = readIndex.load(etl::memory_order_relaxed);
+            const auto &slot = slots[read % SIZE];
+            if (slot.sequence.load(etl::memory_order_acquire) != read + 1)
+            {
+                return nullptr;
+            }
+            return &slot.submission;
+        }
+
+        /**
+         * @brief Consumer, release the frame returned by front() so the slot can be reused.
+         */
+        void pop()
+        {
+            auto read = readIndex.load(etl::memory_order_relaxed);
+            slots[read % SIZE].sequence.store(read + SIZE, etl::memory_order_release);
+            readIndex.store(read + 1, etl::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Number of frames in the queue, including frames that are still being written.
+         */
+        size_t size() const
+        {
+            auto read = readIndex.load(etl::memory_order_relaxed);
+            return writeIndex.load(etl::memory_order_relaxed) - read;
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        /**
+         * @brief Number of frames that did not fit in the queue.
+         */
+        uint32_t dropped() const
+        {
+            return dropped_.load(etl::memory_order_relaxed);
+        }
+    };
+}
@@ -112,7 +112,7 @@ namespace FANET
      * @brief Calculate the airtime of a LoRa packet (integer version).
      *
      * This function calculates the airtime of a LoRa packet based on the provided parameters.
-     * It uses integer arithmetic for the calculations.
+     * It uses integer arithmetic only and can be evaluated at compile time.
      *
      * @param size The size of the payload in bytes.
      * @param sf The spreading factor.
@@ -123,19 +123,19 @@ namespace FANET
      * @param preambleLength The length of the preamble.
      * @return The airtime in milliseconds.
      */
-    static int32_t LoraAirtime(int size,
-                               int sf,
-                               int bw,
-                               int cr = 1, // Coding Rate in 1:4/5 2:4/6 3:4/7 4:4/8
-                               int lowDrOptimize = 2 /*2:auto 1:yes 0:no*/,
-                               bool explicitHeader = true,
-                               int preambleLength = 8)
+    static constexpr int32_t LoraAirtime(int size,
+                                         int sf,
+                                         int bw,
+                                         int cr = 1, // Coding Rate in 1:4/5 2:4/6 3:4/7 4:4/8
+                                         int lowDrOptimize = 2 /*2:auto 1:yes 0:no*/,
+                                         bool explicitHeader = true,
+                                         int preambleLength = 8)
     {
         // Symbol time in milliseconds
         int32_t tSym = 1 << sf;
 
-        // Preamble time
-        int32_t tPreamble = ((preambleLength * 4 + (4 * 4.25)) * tSym) / bw / 4;
+        // Preamble time, (preambleLength + 4.25) symbols
+        int32_t tPreamble = ((preambleLength * 4 + 17) * tSym) / (bw * 4);
 
         // Header: 0 when explicit, 1 when implicit
         int32_t h = explicitHeader ? 0 : 1;
@@ -143,10 +143,11 @@ namespace FANET
         // Low Data Rate Optimization (DE)
         int32_t de = ((lowDrOptimize == 2 && bw == 125 && sf >= 11) || lowDrOptimize == 1) ? 1 : 0;
 
-        // Calculate number of payload symbols
-        int32_t payloadSymbNb = 8 + etl::max(
-                                        (int)std::ceil((8 * size - 4 * sf + 28 + 16 - 20 * h) / (4.0 * (sf - 2 * de))) * (cr + 4),
-                                        0);
+        // Calculate number of payload symbols, the division rounds towards positive infinity
+        int32_t numerator = 8 * size - 4 * sf + 28 + 16 - 20 * h;
+        int32_t denominator = 4 * (sf - 2 * de);
+        int32_t blocks = numerator >= 0 ? (numerator + denominator - 1) / denominator : -(-numerator / denominator);
+        int32_t payloadSymbNb = 8 + (blocks > 0 ? blocks * (cr + 4) : 0);
 
         // Payload time
         int32_t tPayload = (payloadSymbNb * tSym) / bw;
@@ -155,6 +156,56 @@ namespace FANET
         return tPreamble + tPayload;
     }
 
+    /**
+     * @brief Precalculated LoRa airtime for every frame length and coding rate of a fixed modulation.
+     *
+     * The table is generated at compile time with LoraAirtime() and placed in read only memory,
+     * so looking up the airtime of a frame is a single array access.
+     *
+     * @tparam SF The spreading factor.
+     * @tparam BW The bandwidth in kHz.
+     */
+    template <int SF, int BW>
+    class LoraAirtimeTable
+    {
+        struct Table
+        {
+            uint16_t ms[4][256];
+        };
+
+        static constexpr Table build()
+        {
+            Table table{};
+            for (int cr = 1; cr <= 4; cr++)
+            {
+                for (int size = 0; size < 256; size++)
+                {
+                    table.ms[cr - 1][size] = static_cast<uint16_t>(LoraAirtime(size, SF, BW, cr));
+                }
+            }
+            return table;
+        }
+
+        static constexpr Table table = build();
+
+    public:
+        /**
+         * @brief Get the airtime of a frame.
+         * @param size The size of the frame in bytes.
+         * @param cr The coding rate (1:4/5, 2:4/6, 3:4/7, 4:4/8).
+         * @return The airtime in milliseconds.
+         */
+        static constexpr uint16_t get(uint8_t size, uint8_t cr = 1)
+        {
+            return table.ms[etl::clamp<uint8_t>(cr, 1, 4) - 1][size];
+        }
+    };
+
+    /**
+     * @brief Airtime table for the FANET modulation, SF7 with 250kHz bandwidth.
+     */
+    using FanetAirtime = LoraAirtimeTable<7, 250>;
+
     /**
      * @brief calculate the time on air using an EMA filter
      * This will never be a true average and always be an approximate
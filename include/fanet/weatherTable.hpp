@@ -0,0 +1,243 @@
+#pragma once
+
+#include <stdint.h>
+#include "etl/algorithm.h"
+#include "etl/vector.h"
+
+#include "address.hpp"
+#include "service.hpp"
+
+namespace FANET
+{
+    /**
+     * @brief Weather values of a service payload that are aggregated.
+     */
+    enum class WeatherValue : uint8_t
+    {
+        TEMPERATURE = 0, // Degrees celsius
+        WIND_SPEED = 1,  // km/h
+        WIND_GUST = 2,   // km/h
+        HUMIDITY = 3,    // Percent
+        BAROMETRIC = 4,  // hPa
+    };
+
+    static constexpr size_t WEATHER_VALUE_COUNT = 5;
+
+    /**
+     * @brief Minimum, maximum and average of a weather value over the window.
+     */
+    struct WeatherStatistics
+    {
+        float minimum;
+        float maximum;
+        float average;
+        uint16_t count; // Number of reports, 0 when the value was not reported within the window
+    };
+
+    /**
+     * @brief Bounded table of weather stations with the latest report and rolling statistics per station.
+     *
+     * The window is split into BUCKETS buckets that each keep the count, sum, minimum and maximum of every value.
+     * A report is added to the bucket of its time, a bucket from a previous round is cleared first, so there is
+     * no history to aggregate again: statistics combine the buckets within the window.
+     * When the table is full the station that reported the longest time ago is removed.
+     *
+     * @tparam MAX_STATIONS Number of stations.
+     * @tparam BUCKETS Number of buckets per window.
+     */
+    template <size_t MAX_STATIONS, size_t BUCKETS = 6>
+    class WeatherTable
+    {
+    public:
+        static constexpr uint32_t DEFAULT_WINDOW_MS = 60 * 60 * 1000;
+
+        struct Bucket
+        {
+            uint32_t epoch; // Time of the bucket divided by the bucket length
+            float sum[WEATHER_VALUE_COUNT];
+            float minimum[WEATHER_VALUE_COUNT];
+            float maximum[WEATHER_VALUE_COUNT];
+            uint16_t count[WEATHER_VALUE_COUNT];
+        };
+
+        struct Station
+        {
+            Address address;
+            ServicePayload latest;
+            uint32_t lastUpdate;
+            Bucket buckets[BUCKETS];
+        };
+
+    private:
+        etl::vector<Station, MAX_STATIONS> stations_;
+        uint32_t bucketMs_;
+
+        static void add(Bucket &bucket, WeatherValue value, float sample)
+        {
+            auto i = static_cast<uint8_t>(value);
+            bucket.minimum[i] = bucket.count[i] == 0 ? sample : etl::min(bucket.minimum[i], sample);
+            bucket.maximum[i] = bucket.count[i] == 0 ? sample : etl::max(bucket.maximum[i], sample);
+            bucket.sum[i] += sample;
+            bucket.count[i]++;
+        }
+
+        Station *find(const Address &address)
+        {
+            auto it = std::find_if(stations_.begin(), stations_.end(), [&address](const Station &s)
+                                   { return s.address == address; });
+            return it != stations_.end() ? &*it : nullptr;
+        }
+
+    public:
+        /**
+         * @param windowMs Length of the window of the statistics.
+         */
+        WeatherTable(uint32_t windowMs = DEFAULT_WINDOW_MS)
+        {
+            window(windowMs);
+        }
+
+        /**
+         * @brief Change the window of the statistics, this clears the statistics collected so far.
+         */
+        void window(uint32_t windowMs)
+        {
+            bucketMs_ = etl::max(windowMs / static_cast<uint32_t>(BUCKETS), uint32_t(1));
+            for (auto &station : stations_)
+            {
+                for (auto &bucket : station.buckets)
+                {
+                    bucket = Bucket{};
+                }
+            }
+        }
+
+        uint32_t window() const
+        {
+            return bucketMs_ * BUCKETS;
+        }
+
+        void clear()
+        {
+            stations_.clear();
+        }
+
+        size_t size() const
+        {
+            return stations_.size();
+        }
+
+        /**
+         * @brief Add a report of a station, service payloads without weather values are ignored.
+         * @param address The source address of the report.
+         * @param service The received service payload.
+         * @param timeMs Time the report was received.
+         */
+        void update(const Address &address, const ServicePayload &service, uint32_t timeMs)
+        {
+            if (!service.hasTemperature() && !service.hasWind() && !service.hasHumidity() && !service.hasBarometric())
+            {
+                return;
+            }
+
+            auto station = find(address);
+            if (station == nullptr)
+            {
+                if (stations_.full())
+                {
+                    stations_.erase(std::min_element(stations_.begin(), stations_.end(), [](const Station &a, const Station &b)
+                                                     { return static_cast<int32_t>(a.lastUpdate - b.lastUpdate) < 0; }));
+                }
+                stations_.push_back(Station{address, service, timeMs, {}});
+                station = &stations_.back();
+            }
+            station->latest = service;
+            station->lastUpdate = timeMs;
+
+            uint32_t epoch = timeMs / bucketMs_;
+            auto &bucket = station->buckets[epoch % BUCKETS];
+            if (bucket.epoch != epoch)
+            {
+                bucket = Bucket{};
+                bucket.epoch = epoch;
+            }
+
+            if (service.hasTemperature())
+            {
+                add(bucket, WeatherValue::TEMPERATURE, service.temperature());
+            }
+            if (service.hasWind())
+            {
+                add(bucket, WeatherValue::WIND_SPEED, service.windSpeed());
+                add(bucket, WeatherValue::WIND_GUST, service.windGust());
+            }
+            if (service.hasHumidity())
+            {
+                add(bucket, WeatherValue::HUMIDITY, service.humidity());
+            }
+            if (service.hasBarometric())
+            {
+                add(bucket, WeatherValue::BAROMETRIC, service.barometric());
+            }
+        }
+
+        /**
+         * @brief Get the latest report of a station.
+         * @return The report, or nullptr when nothing was received from this address.
+         */
+        const ServicePayload *latest(const Address &address) const
+        {
+            auto it = std::find_if(stations_.begin(), stations_.end(), [&address](const Station &s)
+                                   { return s.address == address; });
+            return it != stations_.end() ? &it->latest : nullptr;
+        }
+
+        /**
+         * @brief Get the statistics of a value of a station over the window that ends at timeMs.
+         */
+        WeatherStatistics statistics(const Station &station, WeatherValue value, uint32_t timeMs) const
+        {
+            auto i = static_cast<uint8_t>(value);
+            uint32_t epoch = timeMs / bucketMs_;
+            WeatherStatistics result{0, 0, 0, 0};
+            float sum = 0;
+            for (const auto &bucket : station.buckets)
+            {
+                // Buckets of a later time than timeMs are skipped as well
+                auto age = static_cast<int32_t>(epoch - bucket.epoch);
+                if (bucket.count[i] == 0 || age < 0 || age >= static_cast<int32_t>(BUCKETS))
+                {
+                    continue;
+                }
+                result.minimum = result.count == 0 ? bucket.minimum[i] : etl::min(result.minimum, bucket.minimum[i]);
+                result.maximum = result.count == 0 ? bucket.maximum[i] : etl::max(result.maximum, bucket.maximum[i]);
+                result.count += bucket.count[i];
+                sum += bucket.sum[i];
+            }
+            if (result.count > 0)
+            {
+                result.average = sum / result.count;
+            }
+            return result;
+        }
+
+        /**
+         * @brief Get the statistics of a value of a station over the window that ends at timeMs.
+         * @return The statistics, count is 0 when the station is not known.
+         */
+        WeatherStatistics statistics(const Address &address, WeatherValue value, uint32_t timeMs) const
+        {
+            auto it = std::find_if(stations_.begin(), stations_.end(), [&address](const Station &s)
+                                   { return s.address == address; });
+            return it != stations_.end() ? statistics(*it, value, timeMs) : WeatherStatistics{0, 0, 0, 0};
+        }
+
+        /**
+         * @brief Get all stations, e.g. for an overview together with statistics().
+         */
+        const etl::ivector<Station> &stations() const
+        {
+            return stations_;
+        }
+    };
+}
@@ -1,12 +1,123 @@
 #pragma once
 
 #include <stdint.h>
+#include <math.h>
 #include "etl/string.h"
 #include "etl/vector.h"
+#include "etl/array.h"
+#include "etl/span.h"
 #include "header.hpp"
+#include "dutyCycle.hpp"
 
 namespace FANET
 {
+    /**
+     * @brief Vertex of a zone polygon in 1/100 degrees.
+     */
+    struct ZoneVertex
+    {
+        int16_t lat;
+        int16_t lon;
+    };
+
+    /**
+     * @brief Geometry of zone polygons on fixed point coordinates in 1/100 degrees.
+     * Polygons are closed implicitly and must not intersect themselves.
+     */
+    struct ZonePolygon
+    {
+        static constexpr int32_t SCALE = 100;
+
+        /**
+         * @brief Even-odd point in polygon test.
+         */
+        static constexpr bool contains(const etl::span<const ZoneVertex> &polygon, int32_t lat, int32_t lon)
+        {
+            bool inside = false;
+            for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++)
+            {
+                int32_t latI = polygon[i].lat, lonI = polygon[i].lon;
+                int32_t latJ = polygon[j].lat, lonJ = polygon[j].lon;
+                if ((latI > lat) != (latJ > lat))
+                {
+                    // Is the point left of the edge at this latitude, compared without division
+                    int64_t dLat = latJ - latI;
+                    int64_t left = static_cast<int64_t>(lon - lonI) * dLat;
+                    int64_t right = static_cast<int64_t>(lonJ - lonI) * (lat - latI);
+                    if (dLat > 0 ? left < right : left > right)
+                    {
+                        inside = !inside;
+                    }
+                }
+            }
+            return inside;
+        }
+
+        /**
+         * @brief Check if any edge of the polygon touches the rectangle.
+         */
+        static constexpr bool edgeCrosses(const etl::span<const ZoneVertex> &polygon, int32_t latLow, int32_t latHigh, int32_t lonLow, int32_t lonHigh)
+        {
+            for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++)
+            {
+                if (segmentTouches(polygon[j], polygon[i], latLow, latHigh, lonLow, lonHigh))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Check if the rectangle lies completely inside the polygon.
+         */
+        static constexpr bool covers(const etl::span<const ZoneVertex> &polygon, int32_t latLow, int32_t latHigh, int32_t lonLow, int32_t lonHigh)
+        {
+            return contains(polygon, latLow, lonLow) && contains(polygon, latLow, lonHigh) &&
+                   contains(polygon, latHigh, lonLow) && contains(polygon, latHigh, lonHigh) &&
+                   !edgeCrosses(polygon, latLow, latHigh, lonLow, lonHigh);
+        }
+
+        /**
+         * @brief Check if the rectangle and the polygon have no area in common.
+         */
+        static constexpr bool disjoint(const etl::span<const ZoneVertex> &polygon, int32_t latLow, int32_t latHigh, int32_t lonLow, int32_t lonHigh)
+        {
+            return !contains(polygon, latLow, lonLow) && !edgeCrosses(polygon, latLow, latHigh, lonLow, lonHigh);
+        }
+
+    private:
+        static constexpr int64_t cross(int64_t aLat, int64_t aLon, int64_t bLat, int64_t bLon, int64_t cLat, int64_t cLon)
+        {
+            return (bLon - aLon) * (cLat - aLat) - (bLat - aLat) * (cLon - aLon);
+        }
+
+        static constexpr bool segmentsTouch(int32_t aLat, int32_t aLon, int32_t bLat, int32_t bLon,
+                                            int32_t cLat, int32_t cLon, int32_t dLat, int32_t dLon)
+        {
+            auto d1 = cross(cLat, cLon, dLat, dLon, aLat, aLon);
+            auto d2 = cross(cLat, cLon, dLat, dLon, bLat, bLon);
+            auto d3 = cross(aLat, aLon, bLat, bLon, cLat, cLon);
+            auto d4 = cross(aLat, aLon, bLat, bLon, dLat, dLon);
+            // Collinear or touching end points count as touching, this only makes the grid more conservative
+            return ((d1 >= 0 && d2 <= 0) || (d1 <= 0 && d2 >= 0)) && ((d3 >= 0 && d4 <= 0) || (d3 <= 0 && d4 >= 0));
+        }
+
+        static constexpr bool segmentTouches(const ZoneVertex &a, const ZoneVertex &b, int32_t latLow, int32_t latHigh, int32_t lonLow, int32_t lonHigh)
+        {
+            auto inRect = [&](const ZoneVertex &v)
+            { return v.lat >= latLow && v.lat <= latHigh && v.lon >= lonLow && v.lon <= lonHigh; };
+            if (inRect(a) || inRect(b))
+            {
+                return true;
+            }
+            return segmentsTouch(a.lat, a.lon, b.lat, b.lon, latLow, lonLow, latLow, lonHigh) ||
+                   segmentsTouch(a.lat, a.lon, b.lat, b.lon, latHigh, lonLow, latHigh, lonHigh) ||
+                   segmentsTouch(a.lat, a.lon, b.lat, b.lon, latLow, lonLow, latHigh, lonLow) ||
+                   segmentsTouch(a.lat, a.lon, b.lat, b.lon, latLow, lonHigh, latHigh, lonHigh);
+        }
+    };
+
     struct ZoneRegion
     {
         const etl::string_view name;
@@ -20,20 +131,126 @@ namespace FANET
         const int16_t lat2; // Latitude 2
         const int16_t lon1; // Longitude 1
         const int16_t lon2; // Longitude 2
+        const etl::span<const ZoneVertex> polygon = {}; // Optional outline within the box, the box is used as prefilter
+        const DutyCycleLimits dutyCycle = {};            // Airtime limits, pass to Protocol::dutyCycleLimits
+
+        /**
+         * @brief Check if a position is in this zone.
+         * @param lat Whole degree latitude, as used for the box.
+         * @param lon Whole degree longitude, as used for the box.
+         * @param latFixed Latitude in 1/100 degrees, as used for the polygon.
+         * @param lonFixed Longitude in 1/100 degrees, as used for the polygon.
+         */
+        bool contains(int16_t lat, int16_t lon, int32_t latFixed, int32_t lonFixed) const
+        {
+            if (lat < lat2 || lat > lat1 || lon < lon2 || lon > lon1)
+            {
+                return false;
+            }
+            return polygon.empty() || ZonePolygon::contains(polygon, latFixed, lonFixed);
+        }
     };
 
     static constexpr auto DEFAULT_ZONE = ZoneRegion{"UNK", {0, -127, 0}, 0, 0, 0, 0};
 
-    static const auto DEFAULT_ZONES = etl::make_vector(
+    // ETSI EN 300 220 sub-band g1, 868.0 - 868.6 MHz: 1% per hour, forwards get half of it
+    static constexpr DutyCycleLimits EU868_DUTY_CYCLE = {3600000, 10, 5};
+    // ARIB STD-T108: 360 s per hour
+    static constexpr DutyCycleLimits AS920_DUTY_CYCLE = {3600000, 100, 50};
+
+    static constexpr etl::array<ZoneRegion, 8> DEFAULT_ZONES = {
         ZoneRegion{"US920", {920800, 15, 500}, 90, -90, -30, -169},
         ZoneRegion{"AU920", {920800, 15, 500}, -10, -48, 179, 110},
         ZoneRegion{"IN866", {868200, 14, 250}, 40, 5, 89, 69},
         ZoneRegion{"KR923", {923200, 15, 125}, 39, 34, 130, 124},
-        ZoneRegion{"AS920", {923200, 15, 125}, 47, 21, 146, 89},
+        ZoneRegion{"AS920", {923200, 15, 125}, 47, 21, 146, 89, {}, AS920_DUTY_CYCLE},
         ZoneRegion{"IL918", {918500, 15, 125}, 34, 29, 36, 34},
-        ZoneRegion{"EU868", {868200, 14, 250}, 90, -90, 180, -180}, // Functions as a catch all with valid lat/lon coordinates
+        ZoneRegion{"EU868", {868200, 14, 250}, 90, -90, 180, -180, {}, EU868_DUTY_CYCLE}, // Functions as a catch all with valid lat/lon coordinates
         DEFAULT_ZONE
-    );
+    };
+
+    /**
+     * @brief Grid of cells over the whole globe that maps a position directly to the index of its zone.
+     *
+     * A cell holds the index of a zone when every whole degree position in the cell resolves to that zone with the
+     * first match rule of Zone::findZone, so the order of the zone list still decides overlapping regions.
+     * Cells crossed by a zone border are marked MIXED and fall back to the linear search.
+     * For polygon zones a cell, grown by one degree on each side to account for the truncation to whole degrees,
+     * must lie completely inside or outside the polygon.
+     * The grid is build at compile time from a constexpr zone list and is stored in flash.
+     */
+    class ZoneGrid
+    {
+    public:
+        static constexpr int16_t CELL_DEG = 5;
+        static constexpr int16_t ROWS = 180 / CELL_DEG + 1; // Whole degree latitudes -90 up to 90
+        static constexpr int16_t COLS = 360 / CELL_DEG + 1; // Whole degree longitudes -180 up to 180
+        static constexpr uint8_t MIXED = 0xFF;
+
+    private:
+        uint8_t cells[ROWS][COLS] = {};
+
+        static constexpr uint8_t resolve(const ZoneRegion *zones, size_t count, int16_t lat, int16_t lon)
+        {
+            // All positions lat..lat+CELL_DEG-1 and lon..lon+CELL_DEG-1, clipped to the globe
+            int16_t latMax = lat + CELL_DEG - 1 > 90 ? 90 : lat + CELL_DEG - 1;
+            int16_t lonMax = lon + CELL_DEG - 1 > 180 ? 180 : lon + CELL_DEG - 1;
+            for (size_t i = 0; i < count; i++)
+            {
+                const auto &zone = zones[i];
+                bool disjoint = latMax < zone.lat2 || lat > zone.lat1 || lonMax < zone.lon2 || lon > zone.lon1;
+                if (!disjoint && !zone.polygon.empty())
+                {
+                    disjoint = ZonePolygon::disjoint(zone.polygon, (lat - 1) * ZonePolygon::SCALE, (latMax + 1) * ZonePolygon::SCALE,
+                                                     (lon - 1) * ZonePolygon::SCALE, (lonMax + 1) * ZonePolygon::SCALE);
+                }
+                if (disjoint)
+                {
+                    continue;
+                }
+                bool covers = lat >= zone.lat2 && latMax <= zone.lat1 && lon >= zone.lon2 && lonMax <= zone.lon1;
+                if (covers && !zone.polygon.empty())
+                {
+                    covers = ZonePolygon::covers(zone.polygon, (lat - 1) * ZonePolygon::SCALE, (latMax + 1) * ZonePolygon::SCALE,
+                                                 (lon - 1) * ZonePolygon::SCALE, (lonMax + 1) * ZonePolygon::SCALE);
+                }
+                return covers ? static_cast<uint8_t>(i) : MIXED;
+            }
+            return static_cast<uint8_t>(count - 1);
+        }
+
+    public:
+        /**
+         * @brief Build the grid for a list of zones, at most 254 zones.
+         * @param zones The zones, ending with DEFAULT_ZONE.
+         */
+        template <typename Zones>
+        static constexpr ZoneGrid build(const Zones &zones)
+        {
+            ZoneGrid grid;
+            for (int16_t row = 0; row < ROWS; row++)
+            {
+                for (int16_t col = 0; col < COLS; col++)
+                {
+                    grid.cells[row][col] = resolve(zones.data(), zones.size(), -90 + row * CELL_DEG, -180 + col * CELL_DEG);
+                }
+            }
+            return grid;
+        }
+
+        /**
+         * @brief Get the zone index of a whole degree position.
+         * @return The index in the zone list, or MIXED when the zone must be searched.
+         */
+        constexpr uint8_t lookup(int16_t lat, int16_t lon) const
+        {
+            if (lat < -90 || lat > 90 || lon < -180 || lon > 180)
+            {
+                return MIXED;
+            }
+            return cells[(lat + 90) / CELL_DEG][(lon + 180) / CELL_DEG];
+        }
+    };
 
     /*
      * The Zone class provides a mechanism to manage and identify regions based on geographic coordinates.
@@ -44,14 +261,19 @@ namespace FANET
     class Zone final
     {
     public:
+        // Grid of the default zones, build at compile time
+        static constexpr ZoneGrid DEFAULT_GRID = ZoneGrid::build(DEFAULT_ZONES);
+
         const etl::span<const ZoneRegion> zones;
+        const ZoneGrid *grid;
 
         // Default constructor uses default zones
-        Zone() : zones(DEFAULT_ZONES) {}
+        Zone() : zones(DEFAULT_ZONES), grid(&DEFAULT_GRID) {}
 
         // Constructor with custom zones
         // When you create your own custom zones you must end it with FANET::DEFAULT_ZONE
-        Zone(const etl::span<ZoneRegion> &custom_zones) : zones(custom_zones) {}
+        // Custom zones declared constexpr can use a grid as well: static constexpr auto MY_GRID = ZoneGrid::build(MY_ZONES);
+        Zone(const etl::span<const ZoneRegion> &custom_zones, const ZoneGrid *custom_grid = nullptr) : zones(custom_zones), grid(custom_grid) {}
 
         /**
          * @brief Based on latitude and longitude find the current zone. When teh zone is known,
@@ -67,9 +289,19 @@ namespace FANET
         {
             int16_t lat = static_cast<int16_t>(latitude);
             int16_t lon = static_cast<int16_t>(longitude);
+            int32_t latFixed = static_cast<int32_t>(roundf(latitude * ZonePolygon::SCALE));
+            int32_t lonFixed = static_cast<int32_t>(roundf(longitude * ZonePolygon::SCALE));
+            if (grid != nullptr)
+            {
+                auto index = grid->lookup(lat, lon);
+                if (index != ZoneGrid::MIXED)
+                {
+                    return zones[index];
+                }
+            }
             for (const auto &zone : zones)
             {
-                if (lat >= zone.lat2 && lat <= zone.lat1 && lon >= zone.lon2 && lon <= zone.lon1)
+                if (zone.contains(lat, lon, latFixed, lonFixed))
                 {
                     return zone;
                 }
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <stdint.h>
+#include "etl/algorithm.h"
+
+#include "zone.hpp"
+
+namespace FANET
+{
+    /**
+     * @brief Follows the zone of a moving position, eg with every GPS fix, and tells when the radio must be retuned.
+     *
+     * The area around the last position in which the zone cannot change is cached, so most updates return without a
+     * lookup. This is the grid cell when it lies within a single zone, else the whole degree cell of the position
+     * as long as there are no polygon zones.
+     * Near a border the zone only changes once the position is at least the hysteresis distance inside the new zone,
+     * so the radio is not reconfigured over and over while flying along a border.
+     */
+    class ZoneTracker
+    {
+    public:
+        /**
+         * @brief Interface to receive zone changes.
+         */
+        class Listener
+        {
+        public:
+            virtual ~Listener() {}
+
+            /**
+             * @brief Called when the zone changed, including the first zone found.
+             * @param zone The new zone.
+             */
+            virtual void zoneChanged(const ZoneRegion &zone) = 0;
+        };
+
+    private:
+        Zone &zone_;
+        Listener *listener_;
+        float hysteresisDeg_;
+        bool hasPolygons_ = false;
+        const ZoneRegion *current_ = nullptr;
+
+        // Whole degree area in which findZone returns the current zone
+        bool cached_ = false;
+        int16_t latMin_ = 0;
+        int16_t latMax_ = 0;
+        int16_t lonMin_ = 0;
+        int16_t lonMax_ = 0;
+
+        void cache(int16_t lat, int16_t lon)
+        {
+            cached_ = true;
+            if (zone_.grid != nullptr && zone_.grid->lookup(lat, lon) != ZoneGrid::MIXED)
+            {
+                latMin_ = -90 + ((lat + 90) / ZoneGrid::CELL_DEG) * ZoneGrid::CELL_DEG;
+                lonMin_ = -180 + ((lon + 180) / ZoneGrid::CELL_DEG) * ZoneGrid::CELL_DEG;
+                latMax_ = latMin_ + ZoneGrid::CELL_DEG - 1;
+                lonMax_ = lonMin_ + ZoneGrid::CELL_DEG - 1;
+            }
+            else if (hasPolygons_)
+            {
+                // A polygon border can cross a whole degree cell
+                cached_ = false;
+            }
+            else
+            {
+                latMin_ = latMax_ = lat;
+                lonMin_ = lonMax_ = lon;
+            }
+        }
+
+        bool wellInside(const ZoneRegion &candidate, float latitude, float longitude)
+        {
+            float latLow = etl::max(latitude - hysteresisDeg_, -90.f);
+            float latHigh = etl::min(latitude + hysteresisDeg_, 90.f);
+            float lonLow = etl::max(longitude - hysteresisDeg_, -180.f);
+            float lonHigh = etl::min(longitude + hysteresisDeg_, 180.f);
+            return &zone_.findZone(latLow, lonLow) == &candidate &&
+                   &zone_.findZone(latLow, lonHigh) == &candidate &&
+                   &zone_.findZone(latHigh, lonLow) == &candidate &&
+                   &zone_.findZone(latHigh, lonHigh) == &candidate;
+        }
+
+    public:
+        /**
+         * @param zone The zones to track.
+         * @param listener Optional listener that is called when the zone changes.
+         * @param hysteresisDeg Distance in degrees the position must be inside a new zone before it is used.
+         */
+        ZoneTracker(Zone &zone, Listener *listener = nullptr, float hysteresisDeg = 0.1f)
+            : zone_(zone), listener_(listener), hysteresisDeg_(hysteresisDeg)
+        {
+            for (const auto &region : zone_.zones)
+            {
+                hasPolygons_ = hasPolygons_ || !region.polygon.empty();
+            }
+        }
+
+        /**
+         * @brief Update the position.
+         * @param latitude The latitude in degrees.
+         * @param longitude The longitude in degrees.
+         * @return True when the zone changed and the radio must be retuned.
+         */
+        bool update(float latitude, float longitude)
+        {
+            int16_t lat = static_cast<int16_t>(latitude);
+            int16_t lon = static_cast<int16_t>(longitude);
+            if (cached_ && lat >= latMin_ && lat <= latMax_ && lon >= lonMin_ && lon <= lonMax_)
+            {
+                return false;
+            }
+
+            const auto &found = zone_.findZone(latitude, longitude);
+            if (&found == current_)
+            {
+                cache(lat, lon);
+                return false;
+            }
+
+            // Close to the border of the new zone, keep the current zone and check again with the next position
+            if (current_ != nullptr && !wellInside(found, latitude, longitude))
+            {
+                cached_ = false;
+                return false;
+            }
+
+            current_ = &found;
+            cache(lat, lon);
+            if (listener_ != nullptr)
+            {
+                listener_->zoneChanged(found);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Get the current zone, DEFAULT_ZONE of the zone list before the first update.
+         */
+        const ZoneRegion &current() const
+        {
+            return current_ != nullptr ? *current_ : zone_.zones.back();
+        }
+
+        /**
+         * @brief Forget the current zone, the next update raises a zone change.
+         */
+        void reset()
+        {
+            current_ = nullptr;
+            cached_ = false;
+        }
+    };
+}
@@ -0,0 +1,69 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/fanet/beacon.hpp"
+
+using namespace FANET;
+
+class NoopProvider : public BeaconProvider
+{
+public:
+    bool fanet_beacon(BeaconType type, Packet<FANET_BEACON_MAXFRAMESIZE> &packet) override
+    {
+        return false;
+    }
+};
+
+TEST_CASE("Beacon interval", "[Beacon]")
+{
+    REQUIRE(BeaconScheduler::interval(BeaconType::TRACKING, 0) == 5000);
+    REQUIRE(BeaconScheduler::interval(BeaconType::TRACKING, 9) == 5000);
+    REQUIRE(BeaconScheduler::interval(BeaconType::TRACKING, 10) == 10000);
+    REQUIRE(BeaconScheduler::interval(BeaconType::TRACKING, 25) == 15000);
+    REQUIRE(BeaconScheduler::interval(BeaconType::NAME, 25) == 240000);
+    REQUIRE(BeaconScheduler::interval(BeaconType::SERVICE, 0) == 40000);
+}
+
+TEST_CASE("BeaconScheduler", "[Beacon]")
+{
+    NoopProvider provider;
+    BeaconScheduler scheduler;
+
+    SECTION("Nothing is due without provider")
+    {
+        REQUIRE(scheduler.due(BeaconType::TRACKING, 1000) == false);
+        REQUIRE(scheduler.nextTx(1000, 2000) == 2000);
+    }
+
+    SECTION("Registered beacon is due immediately and after its interval")
+    {
+        scheduler.provider(BeaconType::TRACKING, &provider, 1000);
+        REQUIRE(scheduler.provider(BeaconType::TRACKING) == &provider);
+        REQUIRE(scheduler.due(BeaconType::TRACKING, 1000) == true);
+        REQUIRE(scheduler.due(BeaconType::NAME, 1000) == false);
+
+        scheduler.sent(BeaconType::TRACKING, 1000, 12);
+        REQUIRE(scheduler.due(BeaconType::TRACKING, 10999) == false);
+        REQUIRE(scheduler.due(BeaconType::TRACKING, 11000) == true);
+        REQUIRE(scheduler.nextTx(1000, 2000) == 2000);
+        REQUIRE(scheduler.nextTx(1500, 20000) == 11000);
+    }
+
+    SECTION("Postpone and stop")
+    {
+        scheduler.provider(BeaconType::SERVICE, &provider, 1000);
+        scheduler.postpone(BeaconType::SERVICE, 3000);
+        REQUIRE(scheduler.due(BeaconType::SERVICE, 2999) == false);
+        REQUIRE(scheduler.nextTx(BeaconType::SERVICE) == 3000);
+
+        scheduler.provider(BeaconType::SERVICE, nullptr, 3000);
+        REQUIRE(scheduler.due(BeaconType::SERVICE, 3000) == false);
+    }
+
+    SECTION("Handles tick wrap around")
+    {
+        scheduler.provider(BeaconType::NAME, &provider, 0);
+        scheduler.sent(BeaconType::NAME, 0xFFFFFF00, 0);
+        REQUIRE(scheduler.due(BeaconType::NAME, 0xFFFFFFFF) == false);
+        REQUIRE(scheduler.due(BeaconType::NAME, BeaconScheduler::NAME_INTERVAL_MS) == true);
+    }
+}
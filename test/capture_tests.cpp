@@ -0,0 +1,190 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/fanet/captureFile.hpp"
+#include "../include/fanet/fanet.hpp"
+#include <stdlib.h>
+#include <vector>
+
+using namespace FANET;
+
+class VectorSink
+{
+public:
+    std::vector<uint8_t> data;
+    size_t limit = SIZE_MAX;
+
+    size_t write(const uint8_t *bytes, size_t size)
+    {
+        size_t written = std::min(size, limit - data.size());
+        data.insert(data.end(), bytes, bytes + written);
+        return written;
+    }
+};
+
+class ReplayApp : public Connector
+{
+public:
+    uint32_t tick = 0;
+    uint32_t received = 0;
+
+    uint32_t fanet_getTick() const override
+    {
+        return tick;
+    }
+
+    bool fanet_sendFrame(uint8_t codingRate, const etl::span<const uint8_t> data) override
+    {
+        return true;
+    }
+
+    void fanet_ackReceived(uint16_t id) override {}
+
+    void fanet_packetReceived(const PacketView &packet, int16_t rssi) override
+    {
+        received++;
+    }
+};
+
+static RadioPacket trackingFrame(const Address &source, int16_t altitude)
+{
+    auto tracking = TrackingPayload{}.latitude(47.f).longitude(8.f).altitude(altitude).speed(36.f).groundTrack(90.f);
+    return Packet<1>().source(source).payload(tracking).build();
+}
+
+static etl::span<const uint8_t> span(const RadioPacket &frame)
+{
+    return etl::span<const uint8_t>(frame.data(), frame.size());
+}
+
+TEST_CASE("Capture", "[Capture]")
+{
+    VectorSink sink;
+    CaptureWriter<VectorSink> writer(sink);
+    auto first = trackingFrame(Address{0x01, 0x0001}, 1000);
+    auto second = trackingFrame(Address{0x01, 0x0002}, 2000);
+
+    REQUIRE(writer.received(1000, -90, 5, span(first)));
+    REQUIRE(writer.transmitted(1500, 8, span(second), 1));
+    REQUIRE(writer.received(0x12345678, -120, 6, span(second), 1));
+    REQUIRE(writer.records() == 3);
+    REQUIRE(sink.data.size() == CAPTURE_HEADER_SIZE + 3 * CAPTURE_RECORD_HEADER_SIZE + first.size() + 2 * second.size());
+
+    SECTION("Reads the records back")
+    {
+        CaptureReader reader(etl::span<const uint8_t>(sink.data.data(), sink.data.size()));
+        REQUIRE(reader.valid());
+
+        std::vector<CaptureRecord> records(reader.begin(), reader.end());
+        REQUIRE(records.size() == 3);
+        REQUIRE(records[0].timeMs == 1000);
+        REQUIRE(records[0].rssi == -90);
+        REQUIRE(records[0].codingRate == 5);
+        REQUIRE(records[0].interface == 0);
+        REQUIRE(records[0].transmitted() == false);
+        REQUIRE(std::vector<uint8_t>(records[0].frame.begin(), records[0].frame.end()) == std::vector<uint8_t>(first.begin(), first.end()));
+        REQUIRE(records[0].frame.data() == sink.data.data() + CAPTURE_HEADER_SIZE + CAPTURE_RECORD_HEADER_SIZE);
+
+        REQUIRE(records[1].transmitted());
+        REQUIRE(records[1].interface == 1);
+
+        REQUIRE(records[2].timeMs == 0x12345678);
+        REQUIRE(records[2].rssi == -120);
+    }
+
+    SECTION("Appends without a second header")
+    {
+        CaptureWriter<VectorSink> append(sink, true);
+        REQUIRE(append.received(2000, -80, 5, span(first)));
+        CaptureReader reader(etl::span<const uint8_t>(sink.data.data(), sink.data.size()));
+        REQUIRE(std::distance(reader.begin(), reader.end()) == 4);
+    }
+
+    SECTION("Ignores a record that was cut off")
+    {
+        CaptureReader reader(etl::span<const uint8_t>(sink.data.data(), sink.data.size() - 1));
+        REQUIRE(std::distance(reader.begin(), reader.end()) == 2);
+
+        CaptureReader header(etl::span<const uint8_t>(sink.data.data(), CAPTURE_HEADER_SIZE + 4));
+        REQUIRE(header.valid());
+        REQUIRE(header.begin() == header.end());
+    }
+
+    SECTION("Rejects other files")
+    {
+        sink.data[0] = 'X';
+        CaptureReader reader(etl::span<const uint8_t>(sink.data.data(), sink.data.size()));
+        REQUIRE(reader.valid() == false);
+        REQUIRE(reader.begin() == reader.end());
+    }
+
+    SECTION("Reports a full sink")
+    {
+        sink.limit = sink.data.size() + 5;
+        REQUIRE(writer.received(3000, -90, 5, span(first)) == false);
+        REQUIRE(writer.records() == 3);
+    }
+}
+
+TEST_CASE("Capture file", "[Capture]")
+{
+    char path[] = "/tmp/fanetCaptureXXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    FILE *file = fdopen(fd, "wb");
+
+    StdioSink sink(file);
+    CaptureWriter<StdioSink> writer(sink);
+    for (uint16_t i = 0; i < 100; i++)
+    {
+        REQUIRE(writer.received(i * 100, -90, 5, span(trackingFrame(Address{0x01, i}, i))));
+    }
+    fclose(file);
+
+    MappedCapture mapped;
+    REQUIRE(mapped.open(path));
+    CaptureReader reader(mapped.data());
+    REQUIRE(reader.valid());
+
+    uint32_t count = 0;
+    for (const auto &record : reader)
+    {
+        REQUIRE(record.timeMs == count * 100);
+        REQUIRE(PacketView(record.frame).source() == Address{0x01, static_cast<uint16_t>(count)});
+        count++;
+    }
+    REQUIRE(count == 100);
+
+    mapped.close();
+    REQUIRE(mapped.data().empty());
+    REQUIRE(mapped.open("/tmp/doesNotExist.fncp") == false);
+    unlink(path);
+}
+
+TEST_CASE("Capture replay", "[Capture]")
+{
+    VectorSink sink;
+    CaptureWriter<VectorSink> writer(sink);
+    writer.received(10000, -90, 5, span(trackingFrame(Address{0x01, 0x0001}, 1000)));
+    writer.transmitted(11000, 5, span(trackingFrame(Address{0x01, 0x0009}, 500)));
+    writer.received(12000, -95, 5, span(trackingFrame(Address{0x01, 0x0002}, 2000)));
+    writer.received(13000, -85, 5, span(trackingFrame(Address{0x01, 0x0001}, 1100)));
+
+    ReplayApp app;
+    Protocol protocol(&app);
+    protocol.ownAddress(Address{0x01, 0x0009});
+
+    std::vector<uint32_t> steps;
+    auto frames = replay(protocol, CaptureReader(etl::span<const uint8_t>(sink.data.data(), sink.data.size())), [&](uint32_t timeMs)
+                         {
+                             app.tick = timeMs;
+                             steps.push_back(timeMs);
+                             protocol.handleTx(); });
+
+    REQUIRE(frames == 3);
+    REQUIRE(app.received == 3);
+    REQUIRE(steps == std::vector<uint32_t>{10000, 11000, 12000, 13000});
+    REQUIRE(protocol.neighborTable().size() == 2);
+    REQUIRE(protocol.neighborTable().lastSeen(Address{0x01, 0x0001}) == 13000);
+    REQUIRE(protocol.trafficTable().find(Address{0x01, 0x0001})->altitude == 1100);
+    REQUIRE(protocol.trafficTable().find(Address{0x01, 0x0002})->lastUpdate == 12000);
+}
@@ -0,0 +1,56 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/fanet/codingRate.hpp"
+#include "helpers.hpp"
+
+using namespace FANET;
+
+TEST_CASE("LinkAdaptiveCodingRatePolicy", "[CodingRate]")
+{
+    LinkAdaptiveCodingRatePolicy policy;
+    auto request = CodingRateRequest{OTHER_ADDRESS_55, -80, 20, 3, 20000, 8};
+
+    SECTION("Short frame to a strong neighbor")
+    {
+        REQUIRE(policy.codingRate(request) == 5);
+    }
+
+    SECTION("Long frame to a strong neighbor")
+    {
+        request.lengthBytes = 100;
+        REQUIRE(policy.codingRate(request) == 8);
+        request.defaultCodingRate = 5;
+        REQUIRE(policy.codingRate(request) == 5);
+    }
+
+    SECTION("Weak or unknown neighbor")
+    {
+        request.rssi = -111;
+        REQUIRE(policy.codingRate(request) == 8);
+        request.rssi = NEIGHBOR_RSSI_UNKNOWN;
+        request.remainingAirtimeMs = 0;
+        REQUIRE(policy.codingRate(request) == 8);
+    }
+
+    SECTION("Broadcast")
+    {
+        request.destination = Address{};
+        request.rssi = NEIGHBOR_RSSI_UNKNOWN;
+        REQUIRE(policy.codingRate(request) == 8);
+
+        SECTION("Low airtime budget")
+        {
+            request.remainingAirtimeMs = 2999;
+            REQUIRE(policy.codingRate(request) == 5);
+        }
+    }
+
+    SECTION("Custom thresholds")
+    {
+        LinkAdaptiveCodingRatePolicy strict(-70, -100, 10, 0);
+        REQUIRE(strict.codingRate(request) == 8);
+        request.rssi = -60;
+        request.lengthBytes = 10;
+        REQUIRE(strict.codingRate(request) == 5);
+    }
+}
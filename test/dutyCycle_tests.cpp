@@ -0,0 +1,137 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/fanet/dutyCycle.hpp"
+#include "../include/fanet/zone.hpp"
+
+using namespace FANET;
+
+TEST_CASE("DutyCycle", "[DutyCycle]")
+{
+    DutyCycle<8> dutyCycle(10000);
+    REQUIRE(dutyCycle.get(0) == 0);
+    REQUIRE(dutyCycle.remaining(0, 100) == 1000);
+    REQUIRE(dutyCycle.timeUntil(0, 100) == 0);
+
+    SECTION("Counts airtime within the window exactly")
+    {
+        dutyCycle.set(1000, 200);
+        dutyCycle.set(2000, 300);
+        REQUIRE(dutyCycle.used(2000) == 500);
+        REQUIRE(dutyCycle.get(2000) == 50);
+        REQUIRE(dutyCycle.remaining(2000, 100) == 500);
+
+        REQUIRE(dutyCycle.used(10999) == 500);
+        REQUIRE(dutyCycle.used(11000) == 300);
+        REQUIRE(dutyCycle.used(12000) == 0);
+        REQUIRE(dutyCycle.getAverage() == 0);
+    }
+
+    SECTION("Time until the budget is available")
+    {
+        dutyCycle.set(1000, 400);
+        dutyCycle.set(2000, 400);
+        dutyCycle.set(3000, 200);
+        REQUIRE(dutyCycle.remaining(4000, 100) == 0);
+
+        REQUIRE(dutyCycle.timeUntil(4000, 100) == 7000);
+        REQUIRE(dutyCycle.timeUntil(4000, 100, 500) == 8000);
+        REQUIRE(dutyCycle.timeUntil(4000, 100, 1000) == 10000);
+        REQUIRE(dutyCycle.timeUntil(4000, 200) == 0);
+        REQUIRE(dutyCycle.timeUntil(4000, 200, 1000) == 7000);
+    }
+
+    SECTION("Moves the oldest records to a bucket when full")
+    {
+        for (uint32_t i = 0; i < 10; i++)
+        {
+            dutyCycle.set(i * 100, 10);
+        }
+        REQUIRE(dutyCycle.used(1000) == 100);
+        // The first two records are counted until the second one expires
+        REQUIRE(dutyCycle.used(10099) == 100);
+        REQUIRE(dutyCycle.used(10100) == 80);
+        REQUIRE(dutyCycle.used(10200) == 70);
+        REQUIRE(dutyCycle.used(10900) == 0);
+    }
+
+    SECTION("Stays bounded above MAX_RECORDS transmissions per window")
+    {
+        // 3 transmissions of 30ms per second, 900ms in the window of 10s
+        uint32_t maximum = 0;
+        for (uint32_t i = 0; i < 3 * 250; i++)
+        {
+            dutyCycle.set(i * 333, 30);
+            if (i > 3 * 10)
+            {
+                maximum = etl::max(maximum, dutyCycle.used(i * 333));
+                REQUIRE(dutyCycle.used(i * 333) >= 900);
+            }
+        }
+        // At most one slot of 10s / 15 counted too long
+        REQUIRE(maximum <= 900 + 3 * 30);
+        REQUIRE(dutyCycle.used(3 * 250 * 333 + 10000) == 0);
+    }
+
+    SECTION("Clear and change window")
+    {
+        dutyCycle.set(1000, 500);
+        dutyCycle.window(5000);
+        REQUIRE(dutyCycle.window() == 5000);
+        REQUIRE(dutyCycle.get(1000) == 100);
+        REQUIRE(dutyCycle.used(6000) == 0);
+
+        dutyCycle.set(7000, 500);
+        dutyCycle.clear();
+        REQUIRE(dutyCycle.used(7000) == 0);
+    }
+
+    SECTION("Keeps records newer than the query time")
+    {
+        dutyCycle.set(1005, 50);
+        REQUIRE(dutyCycle.remaining(1000, 100) == 950);
+        REQUIRE(dutyCycle.used(1010) == 50);
+    }
+
+    SECTION("Handles tick wrap around")
+    {
+        dutyCycle.set(0xFFFFFF00, 100);
+        REQUIRE(dutyCycle.used(100) == 100);
+        REQUIRE(dutyCycle.used(10000) == 0);
+    }
+}
+
+TEST_CASE("Zone duty cycle limits", "[DutyCycle]")
+{
+    Zone zone;
+
+    SECTION("EU868 is limited to 1% per hour")
+    {
+        auto &limits = zone.findZone(52.0f, 4.0).dutyCycle;
+        REQUIRE(limits.windowMs == 3600000);
+        REQUIRE(limits.txPermille == 10);
+        REQUIRE(limits.forwardPermille == 5);
+    }
+
+    SECTION("AS920 is limited to 10% per hour")
+    {
+        auto &limits = zone.findZone(35.0f, 139.0f).dutyCycle;
+        REQUIRE(limits.windowMs == 3600000);
+        REQUIRE(limits.txPermille == 100);
+    }
+
+    SECTION("Regions without a regulatory duty cycle share the channel")
+    {
+        auto &limits = zone.findZone(40.0f, -100.0f).dutyCycle;
+        REQUIRE(limits.windowMs == 30000);
+        REQUIRE(limits.txPermille == 900);
+        REQUIRE(limits.forwardPermille == 500);
+    }
+
+    SECTION("The EU868 budget is 36 s per hour")
+    {
+        DutyCycle<8> dutyCycle(EU868_DUTY_CYCLE.windowMs);
+        dutyCycle.set(0, 30000);
+        REQUIRE(dutyCycle.remaining(1000, EU868_DUTY_CYCLE.txPermille) == 6000);
+        REQUIRE(dutyCycle.remaining(1000, EU868_DUTY_CYCLE.forwardPermille) == 0);
+    }
+}
@@ -0,0 +1,324 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/fanet/fragmentation.hpp"
+#include <functional>
+#include <vector>
+
+using namespace FANET;
+
+static const Address SENDER{0x01, 0x0001};
+static const Address RECEIVER{0x01, 0x0002};
+
+using Fragmenter = MessageFragmenter<1000, 200>;
+using Reassembler = MessageReassembler<2, 1000>;
+
+class Radio : public Connector
+{
+public:
+    uint32_t tick = 0;
+    std::vector<std::vector<uint8_t>> sent;
+    std::function<void(uint16_t, TxStatus)> onTxStatus;
+    std::function<void(const PacketView &)> onPacket;
+
+    uint32_t fanet_getTick() const override
+    {
+        return tick;
+    }
+
+    bool fanet_sendFrame(uint8_t codingRate, const etl::span<const uint8_t> data) override
+    {
+        sent.emplace_back(data.begin(), data.end());
+        return true;
+    }
+
+    void fanet_ackReceived(uint16_t id) override {}
+
+    void fanet_txStatus(uint16_t id, TxStatus status) override
+    {
+        if (onTxStatus)
+        {
+            onTxStatus(id, status);
+        }
+    }
+
+    void fanet_packetReceived(const PacketView &packet, int16_t rssi) override
+    {
+        if (onPacket)
+        {
+            onPacket(packet);
+        }
+    }
+};
+
+static std::vector<uint8_t> testMessage(size_t length)
+{
+    std::vector<uint8_t> message(length);
+    for (size_t i = 0; i < length; i++)
+    {
+        message[i] = static_cast<uint8_t>(i * 7);
+    }
+    return message;
+}
+
+static etl::span<const uint8_t> fragmentPayload(uint8_t messageId, uint8_t index, uint8_t count, uint16_t length, const std::vector<uint8_t> &message)
+{
+    static uint8_t payload[1 + FRAGMENT_HEADER_SIZE + 250];
+    size_t fragmentSize = (length + count - 1) / count;
+    size_t offset = index * fragmentSize;
+    size_t size = std::min(fragmentSize, length - offset);
+    payload[0] = FRAGMENT_SUBHEADER_FLAG | messageId;
+    payload[1] = index;
+    payload[2] = count;
+    payload[3] = length >> 8;
+    payload[4] = length & 0xFF;
+    memcpy(&payload[1 + FRAGMENT_HEADER_SIZE], &message[offset], size);
+    return etl::span<const uint8_t>(payload, 1 + FRAGMENT_HEADER_SIZE + size);
+}
+
+TEST_CASE("MessageReassembler", "[Fragmentation]")
+{
+    Reassembler reassembler;
+    auto message = testMessage(500);
+
+    SECTION("Fragments in any order")
+    {
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(5, 2, 3, 500, message), 0).empty());
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(5, 0, 3, 500, message), 10).empty());
+        auto complete = reassembler.add(SENDER, fragmentPayload(5, 1, 3, 500, message), 20);
+        REQUIRE(std::vector<uint8_t>(complete.begin(), complete.end()) == message);
+    }
+
+    SECTION("Duplicates are ignored")
+    {
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(5, 0, 3, 500, message), 0).empty());
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(5, 0, 3, 500, message), 0).empty());
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(5, 1, 3, 500, message), 0).empty());
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(5, 2, 3, 500, message), 0).size() == 500);
+
+        // Retransmission of a fragment of the completed message
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(5, 2, 3, 500, message), 100).empty());
+    }
+
+    SECTION("Sources are independent")
+    {
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(5, 0, 2, 500, message), 0).empty());
+        REQUIRE(reassembler.add(RECEIVER, fragmentPayload(5, 0, 2, 500, message), 0).empty());
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(5, 1, 2, 500, message), 0).size() == 500);
+        REQUIRE(reassembler.add(RECEIVER, fragmentPayload(5, 1, 2, 500, message), 0).size() == 500);
+    }
+
+    SECTION("A new message id restarts")
+    {
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(5, 0, 2, 500, message), 0).empty());
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(6, 1, 2, 500, message), 0).empty());
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(6, 0, 2, 500, message), 0).size() == 500);
+    }
+
+    SECTION("Incomplete messages time out")
+    {
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(5, 0, 2, 500, message), 0).empty());
+        REQUIRE(reassembler.size() == 1);
+        reassembler.expire(FRAGMENT_REASSEMBLY_TIMEOUT_MS + 1);
+        REQUIRE(reassembler.size() == 0);
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(5, 1, 2, 500, message), FRAGMENT_REASSEMBLY_TIMEOUT_MS + 2).empty());
+    }
+
+    SECTION("A message updated after the expire time is kept")
+    {
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(5, 0, 2, 500, message), 1000).empty());
+        reassembler.expire(900);
+        REQUIRE(reassembler.size() == 1);
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(5, 1, 2, 500, message), 1000).size() == 500);
+    }
+
+    SECTION("The oldest message is replaced when all buffers are used")
+    {
+        Address third{0x01, 0x0003};
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(5, 0, 2, 500, message), 0).empty());
+        REQUIRE(reassembler.add(RECEIVER, fragmentPayload(5, 0, 2, 500, message), 10).empty());
+        REQUIRE(reassembler.add(third, fragmentPayload(5, 0, 2, 500, message), 20).empty());
+        REQUIRE(reassembler.size() == 2);
+        REQUIRE(reassembler.add(SENDER, fragmentPayload(5, 1, 2, 500, message), 30).empty());
+        REQUIRE(reassembler.add(third, fragmentPayload(5, 1, 2, 500, message), 40).size() == 500);
+    }
+
+    SECTION("Invalid fragments are ignored")
+    {
+        auto payload = fragmentPayload(5, 0, 2, 500, message);
+        std::vector<uint8_t> invalid(payload.begin(), payload.end());
+
+        invalid[0] = 5; // Not a fragment
+        REQUIRE(reassembler.add(SENDER, etl::span<const uint8_t>(invalid.data(), invalid.size()), 0).empty());
+        invalid[0] = FRAGMENT_SUBHEADER_FLAG | 5;
+        invalid[1] = 2; // Index beyond the count
+        REQUIRE(reassembler.add(SENDER, etl::span<const uint8_t>(invalid.data(), invalid.size()), 0).empty());
+        invalid[1] = 0;
+        invalid[3] = 0x10; // Longer than MAX_MESSAGE
+        REQUIRE(reassembler.add(SENDER, etl::span<const uint8_t>(invalid.data(), invalid.size()), 0).empty());
+        invalid[3] = 500 >> 8;
+        REQUIRE(reassembler.add(SENDER, etl::span<const uint8_t>(invalid.data(), invalid.size() - 1), 0).empty());
+        REQUIRE(reassembler.size() == 0);
+    }
+}
+
+TEST_CASE("MessageFragmenter", "[Fragmentation]")
+{
+    Fragmenter fragmenter;
+    auto message = testMessage(450);
+
+    REQUIRE(fragmenter.start(Address{}, etl::span<const uint8_t>(), 1, 100) == false);
+    REQUIRE(fragmenter.start(Address{}, etl::span<const uint8_t>(testMessage(1001).data(), 1001), 1, 100) == false);
+    REQUIRE(fragmenter.start(RECEIVER, etl::span<const uint8_t>(message.data(), message.size()), 1, 100));
+    REQUIRE(fragmenter.fragments() == 3);
+    REQUIRE(fragmenter.complete() == false);
+
+    Radio radio;
+    Protocol protocol(&radio);
+    protocol.ownAddress(SENDER);
+    std::vector<uint16_t> queued;
+    radio.onTxStatus = [&](uint16_t id, TxStatus status)
+    {
+        if (status == TxStatus::QUEUED)
+        {
+            queued.push_back(id);
+        }
+        REQUIRE(fragmenter.txStatus(id, status));
+    };
+
+    SECTION("Unicast fragments are send one at a time")
+    {
+        REQUIRE(fragmenter.send(protocol) == 1);
+        REQUIRE(fragmenter.send(protocol) == 0);
+        fragmenter.txStatus(100, TxStatus::TRANSMITTED);
+        REQUIRE(fragmenter.send(protocol) == 0);
+        fragmenter.txStatus(100, TxStatus::ACKED);
+        protocol.init();
+        REQUIRE(fragmenter.send(protocol) == 1);
+        fragmenter.txStatus(101, TxStatus::ACKED);
+        protocol.init();
+        REQUIRE(fragmenter.send(protocol) == 1);
+        REQUIRE(fragmenter.complete() == false);
+        fragmenter.txStatus(102, TxStatus::ACKED);
+        REQUIRE(fragmenter.complete());
+        REQUIRE(queued == std::vector<uint16_t>{100, 101, 102});
+        REQUIRE(fragmenter.txStatus(103, TxStatus::ACKED) == false);
+    }
+
+    SECTION("Lost fragments are resend")
+    {
+        REQUIRE(fragmenter.send(protocol) == 1);
+        fragmenter.txStatus(100, TxStatus::TIMED_OUT);
+        protocol.init();
+        REQUIRE(fragmenter.send(protocol) == 1);
+        REQUIRE(queued == std::vector<uint16_t>{100, 100});
+    }
+
+    SECTION("Fails after all attempts")
+    {
+        for (int attempt = 0; attempt < 3; attempt++)
+        {
+            REQUIRE(fragmenter.failed() == false);
+            REQUIRE(fragmenter.send(protocol) == 1);
+            fragmenter.txStatus(100, TxStatus::TIMED_OUT);
+            protocol.init();
+        }
+        REQUIRE(fragmenter.failed());
+        REQUIRE(fragmenter.complete() == false);
+        REQUIRE(fragmenter.send(protocol) == 0);
+    }
+
+    SECTION("Broadcast fragments are send while the pool has room")
+    {
+        REQUIRE(fragmenter.start(Address{}, etl::span<const uint8_t>(message.data(), message.size()), 2, 100));
+        REQUIRE(fragmenter.send(protocol) == 3);
+        REQUIRE(queued == std::vector<uint16_t>{100, 101, 102});
+        fragmenter.txStatus(100, TxStatus::TRANSMITTED);
+        fragmenter.txStatus(101, TxStatus::DROPPED);
+        fragmenter.txStatus(102, TxStatus::TRANSMITTED);
+        protocol.init();
+        REQUIRE(fragmenter.send(protocol) == 1);
+        fragmenter.txStatus(101, TxStatus::TRANSMITTED);
+        REQUIRE(fragmenter.complete());
+    }
+}
+
+TEST_CASE("Fragmented message over the air", "[Fragmentation]")
+{
+    Radio senderRadio;
+    Radio receiverRadio;
+    Protocol sender(&senderRadio);
+    Protocol receiver(&receiverRadio);
+    sender.ownAddress(SENDER);
+    receiver.ownAddress(RECEIVER);
+
+    Fragmenter fragmenter;
+    Reassembler reassembler;
+    std::vector<uint8_t> received;
+
+    senderRadio.onTxStatus = [&](uint16_t id, TxStatus status)
+    { fragmenter.txStatus(id, status); };
+    receiverRadio.onPacket = [&](const PacketView &packet)
+    {
+        auto complete = reassembler.add(packet, receiverRadio.tick);
+        if (!complete.empty())
+        {
+            received.assign(complete.begin(), complete.end());
+        }
+    };
+
+    // Deliver the frames of both sides, dropping the frames the filter returns true for
+    auto run = [&](uint32_t durationMs, std::function<bool(size_t)> drop)
+    {
+        size_t frame = 0;
+        for (uint32_t t = 0; t < durationMs; t += 5)
+        {
+            senderRadio.tick += 5;
+            receiverRadio.tick += 5;
+            fragmenter.send(sender);
+            sender.handleTx();
+            receiver.handleTx();
+            for (auto &data : senderRadio.sent)
+            {
+                if (!drop(frame++))
+                {
+                    receiver.handleRx(-50, etl::span<const uint8_t>(data.data(), data.size()));
+                }
+            }
+            for (auto &data : receiverRadio.sent)
+            {
+                sender.handleRx(-50, etl::span<const uint8_t>(data.data(), data.size()));
+            }
+            senderRadio.sent.clear();
+            receiverRadio.sent.clear();
+        }
+    };
+
+    auto message = testMessage(1000);
+    REQUIRE(fragmenter.start(RECEIVER, etl::span<const uint8_t>(message.data(), message.size()), 9, 1));
+    REQUIRE(fragmenter.fragments() == 5);
+
+    SECTION("All fragments arrive")
+    {
+        run(60000, [](size_t)
+            { return false; });
+        REQUIRE(fragmenter.complete());
+        REQUIRE(received == message);
+    }
+
+    SECTION("Lost fragments are retransmitted")
+    {
+        run(60000, [](size_t frame)
+            { return frame == 1 || frame == 3 || frame == 4; });
+        REQUIRE(fragmenter.complete());
+        REQUIRE(received == message);
+    }
+
+    SECTION("Broadcast")
+    {
+        REQUIRE(fragmenter.start(Address{}, etl::span<const uint8_t>(message.data(), message.size()), 10, 1));
+        run(60000, [](size_t)
+            { return false; });
+        REQUIRE(fragmenter.complete());
+        REQUIRE(received == message);
+    }
+}
@@ -121,6 +121,19 @@ int16_t altitude_Origional(float altitude)
 }
 
 
+int32_t LoraAirtime_Origional(int size, int sf, int bw, int cr = 1, int lowDrOptimize = 2, bool explicitHeader = true, int preambleLength = 8)
+{
+    int32_t tSym = 1 << sf;
+    int32_t tPreamble = ((preambleLength * 4 + (4 * 4.25)) * tSym) / bw / 4;
+    int32_t h = explicitHeader ? 0 : 1;
+    int32_t de = ((lowDrOptimize == 2 && bw == 125 && sf >= 11) || lowDrOptimize == 1) ? 1 : 0;
+    int32_t payloadSymbNb = 8 + std::max(
+                                    (int)std::ceil((8 * size - 4 * sf + 28 + 16 - 20 * h) / (4.0 * (sf - 2 * de))) * (cr + 4),
+                                    0);
+    int32_t tPayload = (payloadSymbNb * tSym) / bw;
+    return tPreamble + tPayload;
+}
+
 auto OWN_ADDRESS = Address{0x11,0x1111};
 auto OTHER_ADDRESS_55 = Address{0x55,0x5555};
 auto OTHER_ADDRESS_66 = Address{0x66,0x6666};
@@ -0,0 +1,156 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/fanet/fanet.hpp"
+#include "../include/fanet/hwInfoTable.hpp"
+#include "etl/vector.h"
+#include "helpers.hpp"
+
+using namespace FANET;
+
+TEST_CASE("HwInfoPayload Default Constructor", "[HwInfoPayload]")
+{
+    HwInfoPayload payload;
+
+    REQUIRE(payload.type() == Header::MessageType::HW_INFO);
+    REQUIRE(payload.pingPongRequest() == false);
+    REQUIRE(payload.hasDeviceType() == false);
+    REQUIRE(payload.hasIcaoAddress() == false);
+    REQUIRE(payload.hasUptime() == false);
+    REQUIRE(payload.hasRssi() == false);
+}
+
+TEST_CASE("HwInfoPayload build date", "[single-file]")
+{
+    HwInfoPayload payload;
+    payload.deviceType(0x03, 2024, 7, 21, true);
+    REQUIRE(payload.hasDeviceType() == true);
+    REQUIRE(payload.deviceType() == 0x03);
+    REQUIRE(payload.buildYear() == 2024);
+    REQUIRE(payload.buildMonth() == 7);
+    REQUIRE(payload.buildDay() == 21);
+    REQUIRE(payload.experimental() == true);
+    REQUIRE(payload.buildDate() == 0x8AF5);
+
+    payload.deviceType(0x03, 2000, 13, 0);
+    REQUIRE(payload.buildYear() == 2019);
+    REQUIRE(payload.buildMonth() == 12);
+    REQUIRE(payload.buildDay() == 1);
+    REQUIRE(payload.experimental() == false);
+}
+
+TEST_CASE("HwInfoPayload rssi", "[single-file]")
+{
+    HwInfoPayload payload;
+    payload.rssi(-80, Address{0x11, 0x2233});
+    REQUIRE(payload.hasRssi() == true);
+    REQUIRE(payload.rssi() == -80);
+    REQUIRE(payload.rssiAddress() == Address{0x11, 0x2233});
+}
+
+TEST_CASE("HwInfoPayload Serialize/Deserialize", "[single-file]")
+{
+    HwInfoPayload payload;
+    payload.deviceType(0x03, 2024, 7, 21, true)
+        .icaoAddress(0x3C4A5B)
+        .uptime(1234)
+        .rssi(-80, Address{0x11, 0x2233});
+
+    auto result = createRadioPacket(payload);
+    REQUIRE(result == makeVector({0x78, 0x03, 0xF5, 0x8A, 0x5B, 0x4A, 0x3C, 0xD2, 0x04, 0xE2, 0x11, 0x33, 0x22}));
+
+    auto reader = createReader(result);
+    auto received = HwInfoPayload::deserialize(reader, result.size());
+    REQUIRE(received.deviceType() == 0x03);
+    REQUIRE(received.buildYear() == 2024);
+    REQUIRE(received.buildMonth() == 7);
+    REQUIRE(received.buildDay() == 21);
+    REQUIRE(received.experimental() == true);
+    REQUIRE(received.icaoAddress() == 0x3C4A5B);
+    REQUIRE(received.uptime() == 1234);
+    REQUIRE(received.rssi() == -80);
+    REQUIRE(received.rssiAddress() == Address{0x11, 0x2233});
+}
+
+TEST_CASE("HwInfoPayload Ping-Pong request has no data", "[single-file]")
+{
+    HwInfoPayload payload;
+    payload.deviceType(0x03, 2024, 7, 21).uptime(10).pingPongRequest(true);
+
+    auto result = createRadioPacket(payload);
+    REQUIRE(result == makeVector({0xD0}));
+
+    auto reader = createReader(result);
+    auto received = HwInfoPayload::deserialize(reader, result.size());
+    REQUIRE(received.pingPongRequest() == true);
+    REQUIRE(received.hasDeviceType() == true);
+    REQUIRE(received.hasUptime() == true);
+    REQUIRE(received.uptime() == 0);
+}
+
+TEST_CASE("HwInfoPayload truncated", "[single-file]")
+{
+    HwInfoPayload payload;
+    payload.deviceType(0x03, 2024, 7, 21).uptime(1234).rssi(-80, Address{0x11, 0x2233});
+    auto result = createRadioPacket(payload);
+    REQUIRE(HwInfoPayload::requiredSize(result[0]) == result.size());
+
+    // The uptime and rssi flagged in the header are missing
+    auto reader = createReader(result);
+    auto received = HwInfoPayload::deserialize(reader, 4);
+    REQUIRE(received.hasDeviceType() == false);
+    REQUIRE(received.hasUptime() == false);
+    REQUIRE(received.hasRssi() == false);
+    REQUIRE(received.deviceType() == 0);
+}
+
+TEST_CASE("HwInfoPayload PacketParser", "[single-file]")
+{
+    HwInfoPayload payload;
+    payload.deviceType(0x01, 2023, 3, 4).uptime(60);
+    auto v = Packet<1>().source(Address{0x11, 0x2233}).payload(payload).build();
+
+    auto packet = PacketParser<1>::parse(v);
+    REQUIRE(packet.header().type() == Header::MessageType::HW_INFO);
+    auto received = etl::get<HwInfoPayload>(packet.payload().value());
+    REQUIRE(received.deviceType() == 0x01);
+    REQUIRE(received.buildYear() == 2023);
+    REQUIRE(received.uptime() == 60);
+}
+
+TEST_CASE("HwInfoTable", "[HwInfoTable]")
+{
+    HwInfoTable<2> table;
+    HwInfoPayload firmware;
+    firmware.deviceType(0x01, 2023, 3, 4);
+
+    table.addOrUpdate(OTHER_ADDRESS_55, firmware, 10);
+    REQUIRE(table.size() == 1);
+    REQUIRE(table.get(OTHER_ADDRESS_55)->buildYear() == 2023);
+    REQUIRE(table.get(OTHER_ADDRESS_66) == nullptr);
+
+    SECTION("Merges fields of later frames")
+    {
+        table.addOrUpdate(OTHER_ADDRESS_55, HwInfoPayload{}.uptime(30), 20);
+        REQUIRE(table.size() == 1);
+        REQUIRE(table.lastSeen(OTHER_ADDRESS_55) == 20);
+        REQUIRE(table.get(OTHER_ADDRESS_55)->buildYear() == 2023);
+        REQUIRE(table.get(OTHER_ADDRESS_55)->hasUptime() == true);
+        REQUIRE(table.get(OTHER_ADDRESS_55)->uptime() == 30);
+    }
+
+    SECTION("Ignores ping-pong requests")
+    {
+        table.addOrUpdate(OTHER_ADDRESS_66, HwInfoPayload{}.pingPongRequest(true), 20);
+        REQUIRE(table.size() == 1);
+    }
+
+    SECTION("Removes oldest when full")
+    {
+        table.addOrUpdate(OTHER_ADDRESS_66, firmware, 20);
+        table.addOrUpdate(OTHER_ADDRESS_UNR, firmware, 30);
+        REQUIRE(table.size() == 2);
+        REQUIRE(table.get(OTHER_ADDRESS_55) == nullptr);
+        REQUIRE(table.get(OTHER_ADDRESS_66) != nullptr);
+        REQUIRE(table.get(OTHER_ADDRESS_UNR) != nullptr);
+    }
+}
@@ -0,0 +1,136 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/fanet/nameCache.hpp"
+#include <map>
+#include <random>
+#include <string>
+
+using namespace FANET;
+
+TEST_CASE("NameCache", "[NameCache]")
+{
+    NameCache<4, 48> cache;
+    REQUIRE(cache.update(Address{0x01, 0x0001}, "Alice"));
+
+    SECTION("Lookup")
+    {
+        REQUIRE(cache.name(Address{0x01, 0x0001}) == "Alice");
+        REQUIRE(cache.name(Address{0x01, 0x0002}).empty());
+        REQUIRE(cache.contains(Address{0x01, 0x0001}));
+        REQUIRE(cache.bytesUsed() == 10);
+    }
+
+    SECTION("Unchanged names are not written")
+    {
+        REQUIRE(cache.update(Address{0x01, 0x0001}, "Alice") == false);
+        REQUIRE(cache.update(Address{0x01, 0x0001}, "Alina"));
+        REQUIRE(cache.name(Address{0x01, 0x0001}) == "Alina");
+        REQUIRE(cache.bytesUsed() == 10);
+    }
+
+    SECTION("Names of a different length")
+    {
+        REQUIRE(cache.update(Address{0x01, 0x0002}, "Bob"));
+        REQUIRE(cache.update(Address{0x01, 0x0001}, "Alexandra"));
+        REQUIRE(cache.size() == 2);
+        REQUIRE(cache.bytesUsed() == 8 + 14);
+        REQUIRE(cache.name(Address{0x01, 0x0001}) == "Alexandra");
+        REQUIRE(cache.name(Address{0x01, 0x0002}) == "Bob");
+
+        REQUIRE(cache.update(Address{0x01, 0x0001}, "") == true);
+        REQUIRE(cache.contains(Address{0x01, 0x0001}) == false);
+        REQUIRE(cache.bytesUsed() == 8);
+    }
+
+    SECTION("Evicts a name that was not used since the last pass")
+    {
+        REQUIRE(cache.update(Address{0x01, 0x0002}, "Bob"));
+        REQUIRE(cache.update(Address{0x01, 0x0003}, "Carol"));
+        REQUIRE(cache.update(Address{0x01, 0x0004}, "Dave"));
+        cache.name(Address{0x01, 0x0001});
+
+        // Cache is full, Alice was looked up and gets a second chance
+        REQUIRE(cache.update(Address{0x01, 0x0005}, "Eve"));
+        REQUIRE(cache.size() == 4);
+        REQUIRE(cache.contains(Address{0x01, 0x0002}) == false);
+        REQUIRE(cache.name(Address{0x01, 0x0001}) == "Alice");
+
+        // 29 of 48 bytes used and 23 needed, the next name of the hand is removed and the arena compacted
+        cache.remove(Address{0x01, 0x0005});
+        REQUIRE(cache.update(Address{0x01, 0x0006}, "Frederick Longname"));
+        REQUIRE(cache.contains(Address{0x01, 0x0003}) == false);
+        REQUIRE(cache.name(Address{0x01, 0x0001}) == "Alice");
+        REQUIRE(cache.name(Address{0x01, 0x0004}) == "Dave");
+        REQUIRE(cache.name(Address{0x01, 0x0006}) == "Frederick Longname");
+        REQUIRE(cache.bytesUsed() == 10 + 9 + 23);
+    }
+
+    SECTION("Compacts the arena")
+    {
+        // Alternate the length so every update leaves a gap
+        for (int i = 0; i < 50; i++)
+        {
+            REQUIRE(cache.update(Address{0x01, 0x0002}, i % 2 ? "Bob" : "Bobby"));
+            REQUIRE(cache.name(Address{0x01, 0x0001}) == "Alice");
+            REQUIRE(cache.name(Address{0x01, 0x0002}) == (i % 2 ? "Bob" : "Bobby"));
+        }
+        REQUIRE(cache.size() == 2);
+    }
+}
+
+TEST_CASE("NameCache many names", "[NameCache]")
+{
+    NameCache<1000, 12000> cache;
+    char name[8];
+    for (uint16_t i = 0; i < 2000; i++)
+    {
+        snprintf(name, sizeof(name), "P%u", i);
+        cache.update(Address{0x02, i}, name);
+    }
+    REQUIRE(cache.size() == 1000);
+    for (uint16_t i = 0; i < 1000; i++)
+    {
+        REQUIRE(cache.contains(Address{0x02, i}) == false);
+        snprintf(name, sizeof(name), "P%u", i + 1000);
+        REQUIRE(cache.name(Address{0x02, static_cast<uint16_t>(i + 1000)}) == name);
+    }
+}
+
+TEST_CASE("NameCache random updates", "[NameCache]")
+{
+    NameCache<20, 200> cache;
+    std::map<uint16_t, std::string> names;
+    std::mt19937 rng(4711);
+    char name[24];
+    for (int i = 0; i < 20000; i++)
+    {
+        uint16_t unique = rng() % 40;
+        Address address{0x03, unique};
+        switch (rng() % 4)
+        {
+        case 0:
+            cache.remove(address);
+            names.erase(unique);
+            break;
+        case 1:
+            cache.name(address);
+            break;
+        default:
+            snprintf(name, sizeof(name), "%.*s%u", static_cast<int>(rng() % 16), "ABCDEFGHIJKLMNOP", unique);
+            cache.update(address, name);
+            names[unique] = name;
+        }
+
+        size_t contained = 0;
+        for (const auto &entry : names)
+        {
+            if (cache.contains(Address{0x03, entry.first}))
+            {
+                contained++;
+                REQUIRE(cache.name(Address{0x03, entry.first}) == entry.second.c_str());
+            }
+        }
+        REQUIRE(cache.size() == contained);
+        REQUIRE(cache.bytesUsed() <= 200);
+    }
+}
@@ -1,5 +1,6 @@
 #include <catch2/catch_test_macros.hpp>
 #include "../include/fanet/packetParser.hpp"
+#include "../include/fanet/packetView.hpp"
 #include "helpers.hpp"
 #include <catch2/catch_approx.hpp>
 
@@ -59,3 +60,21 @@ TEST_CASE("PacketBuilder Name ", "[single-file]")
     REQUIRE(name.name() == "Hello World" );
 }
 
+TEST_CASE("PacketView", "[single-file]")
+{
+    auto ack = makeVector({0xC0, 0x12, 0x56, 0x34, 0x20, 0x98, 0x54, 0x76});
+    PacketView ackView(ack);
+    REQUIRE(ackView.type() == Header::MessageType::ACK);
+    REQUIRE(ackView.forward() == true);
+    REQUIRE(ackView.source().asUint() == 0x123456);
+    REQUIRE(ackView.destination().asUint() == 0x987654);
+    REQUIRE(ackView.payload().size() == 0);
+    REQUIRE(!ackView.decodePayload<100>());
+
+    auto name = makeVector({0x02, 0x12, 0x56, 0x34, 0x48, 0x65, 0x6C, 0x6C, 0x6F, 0x20, 0x57, 0x6F, 0x72, 0x6C, 0x64, });
+    PacketView nameView(name);
+    REQUIRE(nameView.destination() == Address{});
+    REQUIRE(nameView.ackType() == ExtendedHeader::AckType::NONE);
+    REQUIRE(nameView.payload().size() == 11);
+    REQUIRE(etl::get<NamePayload<100>>(nameView.decodePayload<100>().value()).name() == "Hello World");
+}
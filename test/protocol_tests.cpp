@@ -6,6 +6,7 @@
 #include "../include/fanet/protocol.hpp"
 #include "etl/vector.h"
 #include "helpers.hpp"
+#include <vector>
 
 using namespace FANET;
 
@@ -21,7 +22,8 @@ public:
 
     TxFrame<uint8_t> *getNextTxFrameWrap(uint32_t timeMs)
     {
-        return getNextTxFrame(timeMs);
+        uint32_t readyMs = timeMs;
+        return getNextTxFrame(timeMs, readyMs);
     }
 
     void deleteTxFrame(TxFrame<uint8_t> *frm)
@@ -29,14 +31,14 @@ public:
         txPool.remove(frm);
     }
 
-    void seen(Address address, uint32_t timeMs)
+    void seen(Address address, uint32_t timeMs, int16_t rssi = NEIGHBOR_RSSI_UNKNOWN)
     {
-        neighborTable_.addOrUpdate(address, timeMs);
+        neighborTable_.addOrUpdate(address, timeMs, rssi);
     }
 
-    void setAirTime(float time)
+    void setAirTime(uint16_t timeMs, size_t interface = 0)
     {
-        // airTime(time);
+        interfaces_[interface].dutyCycle.set(connector->fanet_getTick(), timeMs);
     }
 };
 
@@ -47,6 +49,14 @@ public:
     uint32_t receivedAckTotal = 0;
     bool sendFrameResult = true;
     bool sendFrameReceived = false;
+    uint8_t sendFrameCodingRate = 0;
+    bool channelBusy = false;
+    uint32_t packetReceivedTotal = 0;
+    int16_t packetReceivedRssi = 0;
+    bool packetReceivedForward = false;
+    int16_t packetReceivedAltitude = 0;
+    std::vector<TxStatus> txStatuses;
+    std::vector<uint16_t> txStatusIds;
     uint32_t TICK_TIME = 3;
 
     virtual uint32_t fanet_getTick() const override
@@ -62,13 +72,60 @@ public:
     }
 
 
+    virtual bool fanet_channelBusy() override
+    {
+        return channelBusy;
+    }
+
+    virtual void fanet_packetReceived(const PacketView &packet, int16_t rssi) override
+    {
+        packetReceivedTotal++;
+        packetReceivedRssi = rssi;
+        packetReceivedForward = packet.forward();
+        auto payload = packet.decodePayload<1>();
+        if (payload && etl::holds_alternative<TrackingPayload>(*payload))
+        {
+            packetReceivedAltitude = etl::get<TrackingPayload>(*payload).altitude();
+        }
+    }
+
+    virtual void fanet_txStatus(uint16_t id, TxStatus status) override
+    {
+        txStatusIds.push_back(id);
+        txStatuses.push_back(status);
+    }
+
     virtual bool fanet_sendFrame(uint8_t codingRate, const etl::span<const uint8_t> data) override
     {
         sendFrameReceived = true;
+        sendFrameCodingRate = codingRate;
         return sendFrameResult;
     }
 };
 
+class TestBeaconProvider : public BeaconProvider
+{
+public:
+    uint32_t calls = 0;
+    bool provide = true;
+
+    bool fanet_beacon(BeaconType type, Packet<FANET_BEACON_MAXFRAMESIZE> &packet) override
+    {
+        calls++;
+        if (type == BeaconType::TRACKING)
+        {
+            packet.payload(TrackingPayload{}.altitude(100));
+        }
+        else if (type == BeaconType::NAME)
+        {
+            NamePayload<FANET_BEACON_MAXFRAMESIZE> name;
+            name.name("pilot");
+            packet.payload(name);
+        }
+        return provide;
+    }
+};
+
 class TestFixture
 {
 public:
@@ -116,6 +173,88 @@ TEST_CASE_METHOD(TestFixture, "handleRx", "[Protocol]")
         }
     }
 
+    SECTION("Receive queue")
+    {
+        auto v = Packet<1>().source(OTHER_ADDRESS_66).payload(payload).build();
+        auto other = Packet<1>().source(OTHER_ADDRESS_55).payload(payload).build();
+        protocol.rxQueue().push(v, -80, 1);
+        protocol.rxQueue().push(other, -90, 2);
+        app.TICK_TIME = 10;
+
+        SECTION("Uses the time and rssi of reception")
+        {
+            REQUIRE(protocol.processRxQueue() == 2);
+            REQUIRE(protocol.rxQueue().empty());
+            REQUIRE(protocol.stats().rx == 2);
+            REQUIRE(protocol.neighborTable().lastSeen(OTHER_ADDRESS_66) == 1);
+            REQUIRE(protocol.neighborTable().lastSeen(OTHER_ADDRESS_55) == 2);
+            REQUIRE(protocol.neighborTable().rssi(OTHER_ADDRESS_66) == -80);
+        }
+
+        SECTION("Frames received before a transmission keep its airtime")
+        {
+            protocol.rxQueue().pop();
+            protocol.rxQueue().pop();
+            app.TICK_TIME = 1000;
+            protocol.sendPacket(Packet<1>().payload(payload), 0);
+            protocol.handleTx();
+            REQUIRE(app.sendFrameReceived == true);
+            auto airtime = protocol.dutyCycle().used(1000);
+            REQUIRE(airtime > 0);
+
+            // Received while the frame was send, handled afterwards
+            auto forward = Packet<1>().source(OTHER_ADDRESS_66).forward(true).payload(payload).build();
+            protocol.rxQueue().push(forward, RSSI_HIGH, 995);
+            app.TICK_TIME = 1010;
+            REQUIRE(protocol.processRxQueue() == 1);
+            REQUIRE(protocol.stats().forwarded == 1);
+            REQUIRE(protocol.dutyCycle().used(1010) == airtime);
+
+            app.TICK_TIME = 1500;
+            protocol.handleTx();
+            REQUIRE(protocol.dutyCycle().used(1500) > airtime);
+        }
+
+        SECTION("Handles a limited batch")
+        {
+            REQUIRE(protocol.processRxQueue(1) == 1);
+            REQUIRE(protocol.neighborTable().size() == 1);
+            REQUIRE(protocol.processRxQueue(1) == 1);
+            REQUIRE(protocol.processRxQueue(1) == 0);
+            REQUIRE(protocol.neighborTable().size() == 2);
+        }
+    }
+
+    SECTION("Reports received packets to the application")
+    {
+        auto v = Packet<1>().source(OTHER_ADDRESS_66).forward(true).payload(payload).build();
+        protocol.handleRx(RSSI_HIGH, v);
+        REQUIRE(app.packetReceivedTotal == 1);
+        REQUIRE(app.packetReceivedRssi == RSSI_HIGH);
+        REQUIRE(app.packetReceivedForward == true);
+        REQUIRE(app.packetReceivedAltitude == 1000);
+
+        SECTION("Not when the frame is already queued for forwarding")
+        {
+            auto again = Packet<1>().source(OTHER_ADDRESS_66).payload(payload).build();
+            protocol.handleRx(RSSI_HIGH, again);
+            REQUIRE(protocol.stats().fwdDbBoostWeak == 1);
+            REQUIRE(app.packetReceivedTotal == 1);
+        }
+
+        SECTION("Not when addressed to someone else")
+        {
+            protocol.handleRx(RSSI_HIGH, Packet<1>().source(OTHER_ADDRESS_66).destination(OTHER_ADDRESS_55).payload(payload).build());
+            REQUIRE(app.packetReceivedTotal == 1);
+        }
+
+        SECTION("Not when send by ourselves")
+        {
+            protocol.handleRx(RSSI_HIGH, Packet<1>().source(OWN_ADDRESS).payload(payload).build());
+            REQUIRE(app.packetReceivedTotal == 1);
+        }
+    }
+
     SECTION("Ignores Own Address")
     {
         auto v = Packet<1>().source(OWN_ADDRESS).payload(payload).build();
@@ -124,6 +263,68 @@ TEST_CASE_METHOD(TestFixture, "handleRx", "[Protocol]")
         REQUIRE(protocol.neighborTable().size() == 0);
     }
 
+    SECTION("Caches HW info")
+    {
+        HwInfoPayload hwInfo;
+        hwInfo.deviceType(0x01, 2024, 5, 17).uptime(42);
+        auto v = Packet<1>().source(OTHER_ADDRESS_55).payload(hwInfo).build();
+        protocol.handleRx(RSSI_HIGH, v);
+
+        REQUIRE(protocol.hwInfoTable().size() == 1);
+        auto cached = protocol.hwInfoTable().get(OTHER_ADDRESS_55);
+        REQUIRE(cached != nullptr);
+        REQUIRE(cached->deviceType() == 0x01);
+        REQUIRE(cached->buildYear() == 2024);
+        REQUIRE(cached->uptime() == 42);
+        REQUIRE(protocol.hwInfoTable().lastSeen(OTHER_ADDRESS_55) == 3);
+
+        // Uptime flagged but cut off
+        auto truncated = Packet<1>().source(OTHER_ADDRESS_66).payload(hwInfo).build();
+        truncated.resize(truncated.size() - 1);
+        protocol.handleRx(RSSI_HIGH, truncated);
+        REQUIRE(protocol.hwInfoTable().size() == 1);
+        REQUIRE(protocol.hwInfoTable().get(OTHER_ADDRESS_66) == nullptr);
+    }
+
+    SECTION("Updates the traffic table")
+    {
+        protocol.handleRx(RSSI_HIGH, Packet<1>().source(OTHER_ADDRESS_55).payload(TrackingPayload{}.latitude(47.f).altitude(900)).build());
+        protocol.handleRx(RSSI_HIGH, Packet<1>().source(OTHER_ADDRESS_66).payload(GroundTrackingPayload{}.latitude(46.f)).build());
+
+        REQUIRE(protocol.trafficTable().size() == 2);
+        REQUIRE(protocol.trafficTable().find(OTHER_ADDRESS_55)->altitude == 900);
+        REQUIRE(protocol.trafficTable().find(OTHER_ADDRESS_66)->ground);
+        REQUIRE(protocol.trafficTable().find(OTHER_ADDRESS_66)->lastUpdate == 3);
+    }
+
+    SECTION("Updates the weather table")
+    {
+        auto service = ServicePayload{}.latitude(46.f).longitude(8.f).temperature(12.f).windSpeed(20.f).windGust(30.f);
+        protocol.handleRx(RSSI_HIGH, Packet<1>().source(OTHER_ADDRESS_55).payload(service).build());
+        REQUIRE(protocol.weatherTable().size() == 1);
+        REQUIRE(protocol.weatherTable().latest(OTHER_ADDRESS_55)->temperature() == 12.f);
+        REQUIRE(protocol.weatherTable().statistics(OTHER_ADDRESS_55, WeatherValue::WIND_GUST, 3).count == 1);
+
+        // Wind flagged but cut off
+        auto truncated = Packet<1>().source(OTHER_ADDRESS_66).payload(service).build();
+        truncated.resize(truncated.size() - 1);
+        protocol.handleRx(RSSI_HIGH, truncated);
+        REQUIRE(protocol.weatherTable().size() == 1);
+    }
+
+    SECTION("Caches names")
+    {
+        NamePayload<20> name;
+        name.name("Pilot");
+        protocol.handleRx(RSSI_HIGH, Packet<20>().source(OTHER_ADDRESS_55).payload(name).build());
+        REQUIRE(protocol.nameCache().name(OTHER_ADDRESS_55) == "Pilot");
+
+        uint8_t terminated[] = {'P', 'i', 'l', 'o', 't', 0};
+        name.name(etl::string_view(reinterpret_cast<const char *>(terminated), sizeof(terminated)));
+        protocol.handleRx(RSSI_HIGH, Packet<20>().source(OTHER_ADDRESS_66).payload(name).build());
+        REQUIRE(protocol.nameCache().name(OTHER_ADDRESS_66) == "Pilot");
+    }
+
     SECTION("Init should clean ")
     {
         auto v = Packet<1>().source(OTHER_ADDRESS_55).payload(payload).build();
@@ -446,13 +647,13 @@ TEST_CASE_METHOD(TestFixture, "handleRx", "[Protocol]")
                                                               }));
             }
 
-            // TODO: Cannot set this right now
-            // SECTION("Should not forward due to high airtime")
-            // {
-            //     protocol.setAirTime(1000);
-            //     protocol.handleRx(RSSI_HIGH, FORWARDPACKETUNI);
-            //     REQUIRE(protocol.pool().getAllocatedBlocks().size() == 0);
-            // }
+            SECTION("Should not forward due to high airtime")
+            {
+                protocol.setAirTime(15000);
+                protocol.handleRx(RSSI_HIGH, FORWARDPACKETUNI);
+                REQUIRE(protocol.pool().getAllocatedBlocks().size() == 0);
+                REQUIRE(protocol.stats().fwdDropAirtime == 1);
+            }
         }
 
         SECTION("Not Seen, should not add to queue")
@@ -491,6 +692,201 @@ TEST_CASE_METHOD(TestFixture, "sendPacket in strict mode", "[Protocol]")
     }
 }
 
+TEST_CASE_METHOD(TestFixture, "sendPacket admission", "[Protocol]")
+{
+    auto namePacket = Packet<5>().payload(NamePayload<5>{}).destination(OTHER_ADDRESS_55);
+
+    SECTION("Duplicate")
+    {
+        REQUIRE(protocol.sendPacket(namePacket, 1) == Protocol::SendResult::ACCEPTED);
+        REQUIRE(protocol.sendPacket(namePacket, 2) == Protocol::SendResult::DUPLICATE);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 1);
+        REQUIRE(app.txStatuses.back() == TxStatus::REJECTED);
+
+        protocol.admissionPolicy(Protocol::AdmissionPolicy{false});
+        REQUIRE(protocol.sendPacket(namePacket, 3) == Protocol::SendResult::ACCEPTED);
+    }
+
+    SECTION("Pool full")
+    {
+        MessagePayload<200> message;
+        uint8_t text[200] = {};
+        Protocol::SendResult result = Protocol::SendResult::ACCEPTED;
+        uint8_t sent = 0;
+        while (result == Protocol::SendResult::ACCEPTED)
+        {
+            text[0] = sent++;
+            message.message(text);
+            auto packet = Packet<200>().payload(message);
+            result = protocol.sendPacket(packet, sent);
+        }
+        REQUIRE(result == Protocol::SendResult::POOL_FULL);
+        REQUIRE(protocol.canAccept(210) == false);
+        REQUIRE(protocol.canAccept(20) == true);
+    }
+
+    SECTION("Airtime exhausted")
+    {
+        protocol.setAirTime(27000);
+        REQUIRE(protocol.sendPacket(namePacket, 1) == Protocol::SendResult::ACCEPTED);
+
+        protocol.admissionPolicy(Protocol::AdmissionPolicy{true, true});
+        namePacket.destination(OTHER_ADDRESS_66);
+        REQUIRE(protocol.sendPacket(namePacket, 2) == Protocol::SendResult::AIRTIME_EXHAUSTED);
+        REQUIRE(protocol.sendPacket(Packet<1>().payload(payload), 3) == Protocol::SendResult::ACCEPTED);
+    }
+
+    SECTION("Replace the oldest packet of the same type")
+    {
+        protocol.admissionPolicy(Protocol::AdmissionPolicy{true, false, true});
+        REQUIRE(protocol.sendPacket(namePacket, 1) == Protocol::SendResult::ACCEPTED);
+        REQUIRE(protocol.sendPacket(Packet<1>().payload(TrackingPayload{}.altitude(100)), 2) == Protocol::SendResult::ACCEPTED);
+        namePacket.destination(OTHER_ADDRESS_66);
+        REQUIRE(protocol.sendPacket(namePacket, 3) == Protocol::SendResult::REPLACED);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 2);
+        REQUIRE(app.txStatusIds[2] == 1);
+        REQUIRE(app.txStatuses[2] == TxStatus::DROPPED);
+    }
+
+    SECTION("Supersede a queued tracking packet")
+    {
+        app.TICK_TIME = 1000;
+        REQUIRE(protocol.sendPacket(Packet<1>().payload(TrackingPayload{}.altitude(100)), 1) == Protocol::SendResult::ACCEPTED);
+        REQUIRE(protocol.sendPacket(namePacket, 2) == Protocol::SendResult::ACCEPTED);
+        app.TICK_TIME = 3000;
+        REQUIRE(protocol.sendPacket(Packet<1>().payload(TrackingPayload{}.altitude(200)), 3) == Protocol::SendResult::SUPERSEDED);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 2);
+
+        auto &frame = *protocol.pool().begin();
+        REQUIRE(frame.id() == 3);
+        REQUIRE(frame.nextTx() == 1000);
+        REQUIRE(frame.data()[4 + 6] == 200);
+        REQUIRE(app.txStatusIds[2] == 1);
+        REQUIRE(app.txStatuses[2] == TxStatus::DROPPED);
+        REQUIRE(app.txStatusIds[3] == 3);
+        REQUIRE(app.txStatuses[3] == TxStatus::QUEUED);
+    }
+
+    SECTION("Supersede with a longer packet")
+    {
+        app.TICK_TIME = 1000;
+        REQUIRE(protocol.sendPacket(Packet<1>().payload(ServicePayload{}.battery(50)), 1) == Protocol::SendResult::ACCEPTED);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 1);
+        app.TICK_TIME = 3000;
+        auto weather = ServicePayload{}.latitude(47.f).longitude(8.f).temperature(20.f).windHeading(90.f).windSpeed(5.f).windGust(8.f).humidity(60.f).barometric(1013.f).battery(50);
+        REQUIRE(protocol.sendPacket(Packet<1>().payload(weather), 2) == Protocol::SendResult::SUPERSEDED);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 1);
+        REQUIRE(protocol.pool().begin()->data().size() > 16);
+        REQUIRE(protocol.pool().begin()->id() == 2);
+        REQUIRE(protocol.pool().begin()->nextTx() == 1000);
+    }
+
+    SECTION("Keeps the queued packet when the newer one does not fit")
+    {
+        auto fill = [&](uint8_t first)
+        {
+            MessagePayload<5> message;
+            uint8_t text[5] = {};
+            for (uint8_t id = first; id < 100; id++)
+            {
+                text[0] = id;
+                message.message(text);
+                if (protocol.sendPacket(Packet<5>().payload(message), id) != Protocol::SendResult::ACCEPTED)
+                {
+                    break;
+                }
+            }
+        };
+
+        SECTION("Supersede")
+        {
+            REQUIRE(protocol.sendPacket(Packet<1>().payload(ServicePayload{}.battery(50)), 1) == Protocol::SendResult::ACCEPTED);
+            fill(2);
+            auto weather = ServicePayload{}.latitude(47.f).longitude(8.f).temperature(20.f).windHeading(90.f).windSpeed(5.f).windGust(8.f).humidity(60.f).barometric(1013.f).battery(50);
+            REQUIRE(protocol.sendPacket(Packet<1>().payload(weather), 200) == Protocol::SendResult::POOL_FULL);
+        }
+
+        SECTION("Replace the oldest packet of the same type")
+        {
+            REQUIRE(protocol.sendPacket(namePacket, 1) == Protocol::SendResult::ACCEPTED);
+            fill(2);
+            protocol.admissionPolicy(Protocol::AdmissionPolicy{true, false, true});
+            NamePayload<20> longName;
+            longName.name("A much longer name..");
+            REQUIRE(protocol.sendPacket(Packet<20>().payload(longName).destination(OTHER_ADDRESS_66), 200) == Protocol::SendResult::POOL_FULL);
+        }
+
+        REQUIRE(protocol.pool().begin()->id() == 1);
+        REQUIRE(std::count(app.txStatuses.begin(), app.txStatuses.end(), TxStatus::DROPPED) == 0);
+    }
+
+    SECTION("Keeps packets to other destinations and packets that request an ack")
+    {
+        auto tracking = Packet<1>().payload(TrackingPayload{}.altitude(100));
+        REQUIRE(protocol.sendPacket(tracking, 1) == Protocol::SendResult::ACCEPTED);
+        REQUIRE(protocol.sendPacket(Packet<1>().payload(TrackingPayload{}.altitude(200)).destination(OTHER_ADDRESS_55), 2) == Protocol::SendResult::ACCEPTED);
+        REQUIRE(protocol.sendPacket(Packet<1>().payload(TrackingPayload{}.altitude(300)).singleHop(), 3) == Protocol::SendResult::ACCEPTED);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 3);
+    }
+}
+
+TEST_CASE_METHOD(TestFixture, "submitPacket", "[Protocol]")
+{
+    app.TICK_TIME = 50;
+    app.channelBusy = true;
+    auto packet = Packet<1>().payload(payload).singleHop();
+    REQUIRE(protocol.submitPacket(packet, 10));
+
+    SECTION("Is added to the pool by handleTx")
+    {
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 0);
+        REQUIRE(protocol.txQueue().size() == 1);
+
+        protocol.handleTx();
+        REQUIRE(protocol.txQueue().empty());
+        REQUIRE(protocol.pool().begin()->source() == OWN_ADDRESS);
+        REQUIRE(protocol.pool().begin()->id() == 10);
+        REQUIRE(protocol.pool().begin()->forward() == true);
+        REQUIRE(protocol.pool().begin()->self() == true);
+        REQUIRE(protocol.pool().begin()->numTx() == 3);
+        REQUIRE(protocol.pool().begin()->nextTx() == app.TICK_TIME);
+    }
+
+    SECTION("Only the latest position is queued")
+    {
+        auto position = Packet<1>().payload(TrackingPayload{}.altitude(1100));
+        auto latest = Packet<1>().payload(TrackingPayload{}.altitude(1200));
+        REQUIRE(protocol.submitPacket(position, 11));
+        REQUIRE(protocol.submitPacket(latest, 12));
+
+        protocol.handleTx();
+        REQUIRE(protocol.txQueue().empty());
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 2);
+        REQUIRE(app.txStatusIds == std::vector<uint16_t>{10, 11, 11, 12});
+        REQUIRE(app.txStatuses == std::vector<TxStatus>{TxStatus::QUEUED, TxStatus::QUEUED, TxStatus::DROPPED, TxStatus::QUEUED});
+    }
+
+    SECTION("Duplicates are rejected")
+    {
+        REQUIRE(protocol.submitPacket(packet, 11));
+        protocol.handleTx();
+        REQUIRE(protocol.txQueue().empty());
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 1);
+        REQUIRE(app.txStatuses == std::vector<TxStatus>{TxStatus::QUEUED, TxStatus::REJECTED});
+    }
+
+    SECTION("Is dropped when the queue is full")
+    {
+        uint16_t id = 11;
+        while (protocol.submitPacket(packet, id))
+        {
+            id++;
+        }
+        REQUIRE(protocol.txQueue().size() == 8);
+        REQUIRE(protocol.txQueue().dropped() == 1);
+    }
+}
+
 TEST_CASE_METHOD(TestFixture, "getNextTxFrame", "[Protocol]")
 {
     protocol.seen(OTHER_ADDRESS_55, app.TICK_TIME);
@@ -642,10 +1038,19 @@ TEST_CASE_METHOD(TestFixture, "handleTx", "[Protocol]")
 
             SECTION("When Failed, should keep for retry")
             {
+                protocol.tokenBucket(TrafficClass::OWN_OTHER, 1, 30);
                 app.sendFrameResult = false;
                 protocol.handleTx();
                 REQUIRE(app.sendFrameReceived == true);
                 REQUIRE(protocol.pool().getAllocatedBlocks().size() == 1);
+
+                // Nothing went on air, so no airtime is charged and the retry is not held back by the token bucket
+                REQUIRE(protocol.dutyCycle().used(app.TICK_TIME) == 0);
+                app.sendFrameResult = true;
+                app.TICK_TIME += 1000;
+                protocol.handleTx();
+                REQUIRE(protocol.stats().txDeferOther == 0);
+                REQUIRE(protocol.stats().txSuccess == 1);
             }
         }
 
@@ -671,6 +1076,112 @@ TEST_CASE_METHOD(TestFixture, "handleTx", "[Protocol]")
         }
     }
 
+    SECTION("Duty cycle exhausted, should defer until the budget is available")
+    {
+        protocol.setAirTime(27000);
+        auto selfPacket = Packet<5>().payload(NamePayload<5>{}).destination(OTHER_ADDRESS_55);
+        protocol.sendPacket(selfPacket, 0);
+
+        REQUIRE(protocol.handleTx() == 30003);
+        REQUIRE(app.sendFrameReceived == false);
+
+        app.TICK_TIME = 30003;
+        protocol.handleTx();
+        REQUIRE(app.sendFrameReceived == true);
+    }
+
+    SECTION("Token bucket defers own frames so tracking is not starved")
+    {
+        protocol.tokenBucket(TrafficClass::OWN_OTHER, 1, 30);
+        auto namePacket = Packet<5>().payload(NamePayload<5>{}).destination(OTHER_ADDRESS_55);
+        protocol.sendPacket(namePacket, 0);
+        NamePayload<5> otherName;
+        otherName.name("b");
+        namePacket.payload(otherName);
+        protocol.sendPacket(namePacket, 0);
+
+        app.TICK_TIME = protocol.handleTx();
+        REQUIRE(app.sendFrameReceived == true);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 1);
+
+        app.sendFrameReceived = false;
+        protocol.sendPacket(Packet<5>().payload(TrackingPayload{}), 0);
+        protocol.handleTx();
+        REQUIRE(app.sendFrameReceived == true);
+        REQUIRE(protocol.stats().txDeferOther == 1);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 1);
+
+        auto name = findByAddress(protocol, OTHER_ADDRESS_55, OWN_ADDRESS);
+        REQUIRE(name != nullptr);
+        REQUIRE(name->nextTx() > app.TICK_TIME);
+    }
+
+    SECTION("Token bucket drops forwards")
+    {
+        protocol.tokenBucket(TrafficClass::FORWARD, 1, 20);
+        protocol.handleRx(RSSI_HIGH, Packet<1>().source(OTHER_ADDRESS_UNR).destination(OTHER_ADDRESS_66).payload(payload).forward(true).build());
+        protocol.handleRx(RSSI_HIGH, Packet<1>().source(OTHER_ADDRESS_UNR).payload(payload).forward(true).build());
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 2);
+
+        app.TICK_TIME = 1000;
+        app.TICK_TIME = protocol.handleTx();
+        REQUIRE(app.sendFrameReceived == true);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 1);
+
+        app.sendFrameReceived = false;
+        protocol.handleTx();
+        REQUIRE(app.sendFrameReceived == false);
+        REQUIRE(protocol.stats().fwdDropBucket == 1);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 0);
+    }
+
+    SECTION("Channel busy, should back off before sending")
+    {
+        app.channelBusy = true;
+        auto selfPacket = Packet<5>().payload(NamePayload<5>{}).destination(OTHER_ADDRESS_55);
+        protocol.sendPacket(selfPacket, 0);
+
+        auto nextTx = protocol.handleTx();
+        REQUIRE(app.sendFrameReceived == false);
+        REQUIRE(protocol.stats().csmaBusy == 1);
+        REQUIRE(protocol.stats().txFailed == 0);
+        REQUIRE(protocol.csmaState() == Protocol::CsmaState::BACKOFF);
+        REQUIRE(nextTx >= 3 + 64);
+        REQUIRE(nextTx <= 3 + 256);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 1);
+
+        app.TICK_TIME = nextTx - 1;
+        REQUIRE(protocol.handleTx() == nextTx);
+        REQUIRE(protocol.stats().csmaBusy == 1);
+
+        app.channelBusy = false;
+        app.TICK_TIME = nextTx;
+        protocol.handleTx();
+        REQUIRE(app.sendFrameReceived == true);
+        REQUIRE(protocol.csmaState() == Protocol::CsmaState::IDLE);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 0);
+    }
+
+    SECTION("Channel busy, tracking is kept for the next try")
+    {
+        app.channelBusy = true;
+        protocol.sendPacket(Packet<5>().payload(TrackingPayload{}), 0);
+        protocol.handleTx();
+        REQUIRE(app.sendFrameReceived == false);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 1);
+    }
+
+    SECTION("Duty cycle limits can be configured")
+    {
+        protocol.dutyCycleLimits(DutyCycleLimits{60000, 100, 50});
+        protocol.setAirTime(6000);
+        auto selfPacket = Packet<5>().payload(NamePayload<5>{}).destination(OTHER_ADDRESS_55);
+        protocol.sendPacket(selfPacket, 0);
+
+        REQUIRE(protocol.handleTx() == 60003);
+        REQUIRE(app.sendFrameReceived == false);
+    }
+
     SECTION("Package time not ready")
     {
         app.TICK_TIME = 10000;
@@ -681,4 +1192,357 @@ TEST_CASE_METHOD(TestFixture, "handleTx", "[Protocol]")
         REQUIRE(app.sendFrameReceived == false);
         REQUIRE(findByAddress(protocol, OTHER_ADDRESS_55, OWN_ADDRESS) != nullptr);
     }
-}
\ No newline at end of file
+}
+TEST_CASE_METHOD(TestFixture, "Beacons", "[Protocol]")
+{
+    TestBeaconProvider provider;
+
+    SECTION("Tracking is send immediately and then every interval")
+    {
+        protocol.beaconProvider(BeaconType::TRACKING, &provider);
+        protocol.handleTx();
+        REQUIRE(provider.calls == 1);
+        REQUIRE(app.sendFrameReceived == true);
+        REQUIRE(protocol.beacons().nextTx(BeaconType::TRACKING) == 5003);
+
+        app.TICK_TIME = 5002;
+        protocol.handleTx();
+        REQUIRE(provider.calls == 1);
+
+        app.TICK_TIME = 5003;
+        protocol.handleTx();
+        REQUIRE(provider.calls == 2);
+    }
+
+    SECTION("Tracking interval grows with the number of neighbors")
+    {
+        for (uint8_t i = 0; i < 10; i++)
+        {
+            protocol.seen(Address{0x22, i}, app.TICK_TIME);
+        }
+        protocol.beaconProvider(BeaconType::TRACKING, &provider);
+        protocol.handleTx();
+        REQUIRE(protocol.beacons().nextTx(BeaconType::TRACKING) == 10003);
+    }
+
+    SECTION("Returns the next beacon time when the pool is empty")
+    {
+        protocol.beaconProvider(BeaconType::TRACKING, &provider);
+        protocol.handleTx();
+        app.TICK_TIME = 4500;
+        REQUIRE(protocol.handleTx() == 5003);
+    }
+
+    SECTION("Provider can skip a beacon")
+    {
+        provider.provide = false;
+        protocol.beaconProvider(BeaconType::NAME, &provider);
+        protocol.handleTx();
+        REQUIRE(provider.calls == 1);
+        REQUIRE(app.sendFrameReceived == false);
+        REQUIRE(protocol.beacons().nextTx(BeaconType::NAME) == 240003);
+    }
+
+    SECTION("A queued beacon is replaced by the new one")
+    {
+        protocol.beaconProvider(BeaconType::NAME, &provider);
+        app.sendFrameResult = false;
+        protocol.handleTx();
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 1);
+
+        app.TICK_TIME = 240003;
+        protocol.handleTx();
+        REQUIRE(provider.calls == 2);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 1);
+        REQUIRE(std::count(app.txStatuses.begin(), app.txStatuses.end(), TxStatus::DROPPED) == 1);
+    }
+
+    SECTION("A queued tracking beacon keeps its place")
+    {
+        app.channelBusy = true;
+        protocol.beaconProvider(BeaconType::TRACKING, &provider);
+        protocol.handleTx();
+        REQUIRE(app.sendFrameReceived == false);
+
+        app.TICK_TIME = 5003;
+        protocol.handleTx();
+        REQUIRE(provider.calls == 2);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 1);
+        REQUIRE(protocol.pool().begin()->nextTx() == 3);
+        REQUIRE(app.txStatuses == std::vector<TxStatus>{TxStatus::QUEUED, TxStatus::DROPPED, TxStatus::QUEUED});
+    }
+
+    SECTION("Name is postponed when the airtime is above the forward limit")
+    {
+        protocol.setAirTime(15000);
+        protocol.beaconProvider(BeaconType::NAME, &provider);
+        protocol.handleTx();
+        REQUIRE(provider.calls == 0);
+        REQUIRE(protocol.beacons().nextTx(BeaconType::NAME) == 30003);
+    }
+}
+
+TEST_CASE_METHOD(TestFixture, "Coding rate", "[Protocol]")
+{
+    auto unicast = Packet<5>().payload(NamePayload<5>{}).destination(OTHER_ADDRESS_55);
+
+    SECTION("Without policy based on the number of neighbors")
+    {
+        protocol.sendPacket(unicast, 0);
+        protocol.handleTx();
+        REQUIRE(app.sendFrameCodingRate == 8);
+        REQUIRE(protocol.stats().crAirtimeSaved == 0);
+    }
+
+    SECTION("Neighbor rssi is averaged")
+    {
+        protocol.handleRx(-80, Packet<1>().source(OTHER_ADDRESS_55).payload(payload).build());
+        REQUIRE(protocol.neighborTable().rssi(OTHER_ADDRESS_55) == -80);
+        protocol.handleRx(-100, Packet<1>().source(OTHER_ADDRESS_55).payload(payload).build());
+        REQUIRE(protocol.neighborTable().rssi(OTHER_ADDRESS_55) == -90);
+        REQUIRE(protocol.neighborTable().rssi(OTHER_ADDRESS_66) == NEIGHBOR_RSSI_UNKNOWN);
+    }
+
+    SECTION("Link adaptive policy")
+    {
+        LinkAdaptiveCodingRatePolicy policy;
+        protocol.codingRatePolicy(&policy);
+
+        SECTION("Strong neighbor uses 4/5 and saves airtime")
+        {
+            protocol.seen(OTHER_ADDRESS_55, app.TICK_TIME, -70);
+            protocol.sendPacket(unicast, 0);
+            protocol.handleTx();
+            REQUIRE(app.sendFrameCodingRate == 5);
+            REQUIRE(protocol.stats().crAirtimeSaved > 0);
+        }
+
+        SECTION("Weak neighbor uses 4/8")
+        {
+            protocol.seen(OTHER_ADDRESS_55, app.TICK_TIME, -115);
+            protocol.sendPacket(unicast, 0);
+            protocol.handleTx();
+            REQUIRE(app.sendFrameCodingRate == 8);
+            REQUIRE(protocol.stats().crAirtimeSaved == 0);
+        }
+
+        SECTION("Low airtime budget uses 4/5 for broadcasts")
+        {
+            protocol.setAirTime(25000);
+            protocol.sendPacket(Packet<5>().payload(TrackingPayload{}), 0);
+            protocol.handleTx();
+            REQUIRE(app.sendFrameCodingRate == 5);
+        }
+    }
+}
+
+TEST_CASE_METHOD(TestFixture, "Multiple radios", "[Protocol]")
+{
+    TestApp second;
+    REQUIRE(protocol.addInterface(&second) == 1);
+    REQUIRE(protocol.addInterface(&second) == -1);
+    REQUIRE(protocol.interfaceCount() == 2);
+
+    SECTION("A frame received by both radios is handled once")
+    {
+        // Each radio has its own receive buffer
+        auto v = Packet<1>().source(OTHER_ADDRESS_66).forward(true).payload(payload).build();
+        auto rx0 = v;
+        auto rx1 = v;
+        protocol.handleRx(RSSI_HIGH, rx0, 3, 0);
+        protocol.handleRx(RSSI_HIGH, rx1, 4, 1);
+        REQUIRE(protocol.stats().rxDuplicate == 1);
+        REQUIRE(protocol.stats().forwarded == 1);
+        REQUIRE(app.packetReceivedTotal == 1);
+        REQUIRE(protocol.stats().fwdDbBoostWeak == 0);
+        REQUIRE(protocol.neighborTable().size() == 1);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() > 0);
+
+        SECTION("Again on the same radio is a retransmission")
+        {
+            protocol.handleRx(RSSI_HIGH, v, 5, 0);
+            REQUIRE(protocol.stats().rxDuplicate == 1);
+            REQUIRE(protocol.stats().fwdDbBoostWeak == 1);
+        }
+
+        SECTION("Much later on the other radio is a retransmission")
+        {
+            protocol.handleRx(RSSI_HIGH, v, 500, 1);
+            REQUIRE(protocol.stats().rxDuplicate == 1);
+            REQUIRE(protocol.stats().fwdDbBoostWeak == 1);
+        }
+    }
+
+    SECTION("Sends on the radio with the most airtime left")
+    {
+        protocol.setAirTime(2000, 0);
+        protocol.sendPacket(Packet<5>().payload(NamePayload<5>{}), 0);
+        protocol.handleTx();
+        REQUIRE(app.sendFrameReceived == false);
+        REQUIRE(second.sendFrameReceived == true);
+        REQUIRE(protocol.dutyCycle(1).used(app.TICK_TIME) > 0);
+    }
+
+    SECTION("Acks are send by the radio that received the frame")
+    {
+        protocol.setAirTime(2000, 1);
+        auto v = Packet<1>().source(OTHER_ADDRESS_66).destination(OWN_ADDRESS).singleHop().payload(payload).build();
+        protocol.handleRx(RSSI_HIGH, v, 3, 1);
+        REQUIRE(protocol.stats().txAck == 1);
+
+        protocol.handleTx();
+        REQUIRE(app.sendFrameReceived == false);
+        REQUIRE(second.sendFrameReceived == true);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 0);
+    }
+
+    SECTION("Forwards are send by the radio that received the frame")
+    {
+        protocol.setAirTime(2000, 1);
+        auto v = Packet<1>().source(OTHER_ADDRESS_66).forward(true).payload(payload).build();
+        protocol.handleRx(-110, v, 3, 1);
+        REQUIRE(protocol.stats().forwarded == 1);
+
+        app.TICK_TIME = second.TICK_TIME = 3 + 1000;
+        protocol.handleTx();
+        REQUIRE(app.sendFrameReceived == false);
+        REQUIRE(second.sendFrameReceived == true);
+    }
+
+    SECTION("A busy radio gives way to the other radio")
+    {
+        app.channelBusy = true;
+        protocol.sendPacket(Packet<5>().payload(NamePayload<5>{}), 0);
+        REQUIRE(protocol.handleTx() == app.TICK_TIME);
+        REQUIRE(protocol.csmaState(0) == Protocol::CsmaState::BACKOFF);
+
+        protocol.handleTx();
+        REQUIRE(app.sendFrameReceived == false);
+        REQUIRE(second.sendFrameReceived == true);
+        REQUIRE(protocol.csmaState(1) == Protocol::CsmaState::IDLE);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 0);
+    }
+
+    SECTION("A radio without airtime does not hold back the other radio")
+    {
+        auto forward = Packet<1>().source(OTHER_ADDRESS_55).forward(true).payload(payload).build();
+        protocol.handleRx(-110, forward, 3, 0);
+        REQUIRE(protocol.stats().forwarded == 1);
+        auto v = Packet<1>().source(OTHER_ADDRESS_66).destination(OWN_ADDRESS).singleHop().payload(payload).build();
+        protocol.handleRx(RSSI_HIGH, v, 3, 1);
+        REQUIRE(protocol.stats().txAck == 1);
+        protocol.setAirTime(30000, 0);
+
+        // The forward waits for the airtime of radio 0, the ack goes out on radio 1
+        app.TICK_TIME = second.TICK_TIME = 3 + 1000;
+        protocol.handleTx();
+        REQUIRE(app.sendFrameReceived == false);
+        REQUIRE(second.sendFrameReceived == true);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() > 0);
+
+        // Nothing left to send now, wait until radio 0 has airtime again instead of a busy loop
+        second.sendFrameReceived = false;
+        REQUIRE(protocol.handleTx() == 30003);
+        REQUIRE(app.sendFrameReceived == false);
+        REQUIRE(second.sendFrameReceived == false);
+    }
+}
+
+TEST_CASE_METHOD(TestFixture, "Radios on the same channel", "[Protocol]")
+{
+    TestApp second;
+    REQUIRE(protocol.addInterface(&second, 0) == 1);
+
+    protocol.sendPacket(Packet<5>().payload(NamePayload<5>{}), 0);
+    protocol.sendPacket(Packet<5>().payload(NamePayload<5>{}).destination(OTHER_ADDRESS_66), 0);
+    auto nextTx = protocol.handleTx();
+    REQUIRE(app.sendFrameReceived != second.sendFrameReceived);
+
+    // The other radio waits until the first transmission is done
+    REQUIRE(nextTx > app.TICK_TIME);
+    app.sendFrameReceived = second.sendFrameReceived = false;
+    REQUIRE(protocol.handleTx() == nextTx);
+    REQUIRE(app.sendFrameReceived == false);
+    REQUIRE(second.sendFrameReceived == false);
+}
+
+TEST_CASE_METHOD(TestFixture, "TX status", "[Protocol]")
+{
+    SECTION("Without ack")
+    {
+        protocol.sendPacket(Packet<5>().payload(NamePayload<5>{}), 5);
+        protocol.handleTx();
+        REQUIRE(app.txStatuses == std::vector<TxStatus>{TxStatus::QUEUED, TxStatus::TRANSMITTED});
+        REQUIRE(app.txStatusIds == std::vector<uint16_t>{5, 5});
+    }
+
+    SECTION("Retransmitted until timed out")
+    {
+        auto packet = Packet<1>().payload(NamePayload<1>{}).destination(OTHER_ADDRESS_55).singleHop();
+        protocol.sendPacket(packet, 6);
+        for (int i = 0; i < 10 && protocol.pool().getAllocatedBlocks().size() > 0; i++)
+        {
+            protocol.handleTx();
+            app.TICK_TIME += 5000;
+        }
+        REQUIRE(app.txStatuses == std::vector<TxStatus>{TxStatus::QUEUED, TxStatus::TRANSMITTED, TxStatus::RETRANSMITTED, TxStatus::RETRANSMITTED, TxStatus::TIMED_OUT});
+    }
+
+    SECTION("Timed out while the token bucket is empty")
+    {
+        protocol.tokenBucket(TrafficClass::OWN_OTHER, 1, 30);
+        auto packet = Packet<1>().payload(NamePayload<1>{}).destination(OTHER_ADDRESS_55).singleHop();
+        protocol.sendPacket(packet, 6);
+        for (int i = 0; i < 100 && app.txStatuses.size() < 4; i++)
+        {
+            protocol.handleTx();
+            app.TICK_TIME += 5000;
+        }
+        REQUIRE(app.txStatuses.back() == TxStatus::RETRANSMITTED);
+
+        protocol.handleTx();
+        REQUIRE(app.txStatuses.back() == TxStatus::TIMED_OUT);
+        REQUIRE(protocol.pool().getAllocatedBlocks().size() == 0);
+    }
+
+    SECTION("Acked")
+    {
+        auto packet = Packet<1>().payload(NamePayload<1>{}).destination(OTHER_ADDRESS_55).singleHop();
+        protocol.sendPacket(packet, 7);
+        protocol.handleTx();
+        protocol.handleRx(RSSI_HIGH, Packet<1>().source(OTHER_ADDRESS_55).destination(OWN_ADDRESS).buildAck());
+        REQUIRE(app.txStatuses == std::vector<TxStatus>{TxStatus::QUEUED, TxStatus::TRANSMITTED, TxStatus::ACKED});
+        REQUIRE(app.receivedAckId == 7);
+    }
+
+    SECTION("Tracking the radio failed to send")
+    {
+        app.sendFrameResult = false;
+        protocol.sendPacket(Packet<1>().payload(payload), 8);
+        protocol.handleTx();
+        REQUIRE(app.txStatuses == std::vector<TxStatus>{TxStatus::QUEUED, TxStatus::DROPPED});
+    }
+
+    SECTION("Rejected when the pool is full")
+    {
+        MessagePayload<200> message;
+        uint8_t text[200] = {};
+        message.message(text);
+        auto packet = Packet<200>().payload(message);
+        for (uint16_t id = 1; id <= 10; id++)
+        {
+            protocol.sendPacket(packet, id);
+        }
+        REQUIRE(app.txStatuses.back() == TxStatus::REJECTED);
+        REQUIRE(app.txStatuses.front() == TxStatus::QUEUED);
+    }
+
+    SECTION("Frames of others are not reported")
+    {
+        protocol.handleRx(RSSI_HIGH, Packet<1>().source(OTHER_ADDRESS_66).forward(true).payload(payload).build());
+        app.TICK_TIME += 1000;
+        protocol.handleTx();
+        REQUIRE(protocol.stats().forwarded == 1);
+        REQUIRE(app.txStatuses.empty());
+    }
+}
@@ -0,0 +1,166 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include "../include/fanet/proximityAlert.hpp"
+
+using namespace FANET;
+
+namespace
+{
+    constexpr float DEGREES_PER_METER = 1.f / 111195.f;
+    constexpr float LATITUDE = 47.f;
+    constexpr float LONGITUDE = 8.f;
+
+    TrackingPayload target(float northM, float eastM, int16_t altitude, float speed, float heading)
+    {
+        return TrackingPayload{}
+            .latitude(LATITUDE + northM * DEGREES_PER_METER)
+            .longitude(LONGITUDE + eastM * DEGREES_PER_METER / 0.68200f)
+            .altitude(altitude)
+            .speed(speed)
+            .groundTrack(heading)
+            .aircraftType(TrackingPayload::AircraftType::PARAGLIDER);
+    }
+}
+
+TEST_CASE("ProximityAlert", "[ProximityAlert]")
+{
+    TrafficTable<8> traffic;
+    ProximityAlert<> alerts;
+    Ownship own{LATITUDE, LONGITUDE, 1000, 36.f, 0.f, 0.f};
+
+    SECTION("No traffic")
+    {
+        REQUIRE(alerts.update(own, traffic, 0).empty());
+        REQUIRE(alerts.level() == AlertLevel::NONE);
+    }
+
+    SECTION("Head on")
+    {
+        traffic.update(Address{0x01, 0x0001}, target(240, 0, 1000, 36.f, 180.f), 0);
+        auto &result = alerts.update(own, traffic, 0);
+        REQUIRE(result.size() == 1);
+        REQUIRE(result[0].address == Address{0x01, 0x0001});
+        REQUIRE(result[0].level == AlertLevel::IMPORTANT);
+        REQUIRE(result[0].timeToCpaMs == Catch::Approx(12000).margin(300));
+        REQUIRE(result[0].cpaDistanceM < 5);
+        REQUIRE(result[0].cpaVerticalM == 0);
+    }
+
+    SECTION("Separated vertically")
+    {
+        traffic.update(Address{0x01, 0x0001}, target(240, 0, 1300, 36.f, 180.f), 0);
+        REQUIRE(alerts.update(own, traffic, 0).empty());
+    }
+
+    SECTION("Parallel track")
+    {
+        traffic.update(Address{0x01, 0x0001}, target(0, 1000, 1000, 36.f, 0.f), 0);
+        REQUIRE(alerts.update(own, traffic, 0).empty());
+    }
+
+    SECTION("Already too close")
+    {
+        traffic.update(Address{0x01, 0x0001}, target(0, 50, 1020, 36.f, 0.f), 0);
+        auto &result = alerts.update(own, traffic, 0);
+        REQUIRE(result.size() == 1);
+        REQUIRE(result[0].level == AlertLevel::URGENT);
+        REQUIRE(result[0].timeToCpaMs == 0);
+        REQUIRE(result[0].cpaDistanceM == Catch::Approx(50).margin(2));
+        REQUIRE(result[0].cpaVerticalM == 20);
+    }
+
+    SECTION("Closest approach after the lookahead")
+    {
+        own.speed = 0;
+        traffic.update(Address{0x01, 0x0001}, target(0, 300, 1000, 36.f, 270.f), 0);
+        auto &result = alerts.update(own, traffic, 0);
+        REQUIRE(result.size() == 1);
+        REQUIRE(result[0].level == AlertLevel::LOW);
+        REQUIRE(result[0].timeToCpaMs == 20000);
+        REQUIRE(result[0].cpaDistanceM == Catch::Approx(100).margin(3));
+    }
+
+    SECTION("Turning target")
+    {
+        own.speed = 0;
+        traffic.update(Address{0x01, 0x0001}, target(0, 300, 1000, 36.f, 270.f).turnRate(18.f), 0);
+        REQUIRE(alerts.update(own, traffic, 0).empty());
+    }
+
+    SECTION("Turning into the own track")
+    {
+        // Passes 250m east when flying straight, turns left towards us
+        own.speed = 0;
+        traffic.update(Address{0x01, 0x0001}, target(-100, 250, 1000, 36.f, 0.f), 0);
+        REQUIRE(alerts.update(own, traffic, 0).empty());
+
+        traffic.update(Address{0x01, 0x0001}, target(-100, 250, 1000, 36.f, 0.f).turnRate(-9.f), 0);
+        auto &result = alerts.update(own, traffic, 0);
+        REQUIRE(result.size() == 1);
+        REQUIRE(result[0].timeToCpaMs > 0);
+    }
+
+    SECTION("Reports are moved forward by their age")
+    {
+        own.speed = 0;
+        traffic.update(Address{0x01, 0x0001}, target(150, 0, 1000, 36.f, 0.f), 0);
+        REQUIRE(alerts.update(own, traffic, 0).size() == 1);
+        REQUIRE(alerts.update(own, traffic, 10000).empty());
+    }
+
+    SECTION("Ground tracking is ignored")
+    {
+        traffic.update(Address{0x01, 0x0001}, GroundTrackingPayload{}.latitude(LATITUDE).longitude(LONGITUDE), 0);
+        REQUIRE(alerts.update(own, traffic, 0).empty());
+    }
+
+    SECTION("Own aircraft turning into a target")
+    {
+        traffic.update(Address{0x01, 0x0001}, target(-100, 250, 1000, 0.f, 0.f), 0);
+        REQUIRE(alerts.update(own, traffic, 0).empty());
+
+        own.turnRate = 9.f;
+        REQUIRE(alerts.update(own, traffic, 0).size() == 1);
+    }
+
+    SECTION("Fifty targets")
+    {
+        TrafficTable<50> crowd;
+        for (uint16_t i = 0; i < 49; i++)
+        {
+            if (i % 5 == 0)
+            {
+                crowd.update(Address{0x02, i}, GroundTrackingPayload{}.latitude(LATITUDE).longitude(LONGITUDE), 0);
+            }
+            else
+            {
+                crowd.update(Address{0x02, i}, target(2000 + i * 100, 1000, 1000, 36.f, (i % 2) ? 0.f : 90.f).turnRate(i % 3 ? 0.f : 9.f), 0);
+            }
+        }
+        crowd.update(Address{0x01, 0x0001}, target(240, 0, 1000, 36.f, 180.f), 0);
+        REQUIRE(crowd.size() == 50);
+
+        auto &result = alerts.update(own, crowd, 0);
+        REQUIRE(result.size() == 1);
+        REQUIRE(result[0].address == Address{0x01, 0x0001});
+        REQUIRE(result[0].timeToCpaMs == Catch::Approx(12000).margin(300));
+    }
+
+    SECTION("Keeps the most severe alerts")
+    {
+        ProximityAlert<1> single;
+        traffic.update(Address{0x01, 0x0001}, target(240, 0, 1000, 36.f, 180.f), 0);
+        traffic.update(Address{0x01, 0x0002}, target(0, 50, 1000, 36.f, 0.f), 0);
+        traffic.update(Address{0x01, 0x0003}, target(300, 0, 1000, 36.f, 180.f), 0);
+        auto &result = single.update(own, traffic, 0);
+        REQUIRE(result.size() == 1);
+        REQUIRE(result[0].address == Address{0x01, 0x0002});
+
+        REQUIRE(alerts.update(own, traffic, 0).size() == 3);
+        REQUIRE(alerts.alerts()[0].address == Address{0x01, 0x0002});
+        REQUIRE(alerts.alerts()[1].address == Address{0x01, 0x0001});
+        REQUIRE(alerts.alerts()[2].address == Address{0x01, 0x0003});
+        REQUIRE(alerts.level() == AlertLevel::URGENT);
+    }
+}
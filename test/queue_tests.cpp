@@ -87,4 +87,56 @@ TEST_CASE("Queue tests Monkey", "[BlockAllocator]")
         // printf("Deleted: ");
         // test.printAllocationMap();
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Queue canAdd", "[BlockAllocator]")
+{
+    BlockAllocator<TestData, 4, 10> test;
+    uint8_t externalArray[40] = {};
+
+    REQUIRE(test.canAdd(40));
+    REQUIRE(test.canAdd(41) == false);
+
+    REQUIRE(test.add(TestData{0, 0, etl::span<uint8_t>(externalArray, 25)}));
+    REQUIRE(test.canAdd(10));
+    REQUIRE(test.canAdd(11) == false);
+    REQUIRE(test.add(TestData{1, 0, etl::span<uint8_t>(externalArray, 11)}) == false);
+
+    test.remove(test.begin());
+    REQUIRE(test.canAdd(40));
+}
+
+TEST_CASE("Queue canAdd after a removal", "[BlockAllocator]")
+{
+    BlockAllocator<TestData, 4, 10> test;
+    uint8_t externalArray[40] = {};
+
+    REQUIRE(test.add(TestData{0, 0, etl::span<uint8_t>(externalArray, 10)}));
+    REQUIRE(test.add(TestData{1, 0, etl::span<uint8_t>(externalArray, 15)}));
+    REQUIRE(test.canAdd(30) == false);
+    REQUIRE(test.canAdd(30, test.begin()) == false);
+    REQUIRE(test.canAdd(30, test.begin() + 1));
+    REQUIRE(test.canAdd(40, test.begin() + 1) == false);
+
+    BlockAllocator<TestData, 2, 10> full;
+    REQUIRE(full.add(TestData{0, 0, etl::span<uint8_t>(externalArray, 10)}));
+    REQUIRE(full.add(TestData{1, 0, etl::span<uint8_t>(externalArray, 10)}));
+    REQUIRE(full.canAdd(10) == false);
+    REQUIRE(full.canAdd(10, full.begin()));
+}
+
+TEST_CASE("Queue replace", "[BlockAllocator]")
+{
+    BlockAllocator<TestData, 4, 10> test;
+    uint8_t first[15] = {1, 1, 1};
+    uint8_t second[12] = {2, 2, 2};
+
+    REQUIRE(test.add(TestData{0, 0, etl::span<uint8_t>(first, 15)}));
+    REQUIRE(test.replace(test.begin(), etl::span<const uint8_t>(second, 12)));
+    REQUIRE(test.begin()->data().size() == 12);
+    REQUIRE(test.begin()->data()[0] == 2);
+
+    // Needs one block less
+    REQUIRE(test.replace(test.begin(), etl::span<const uint8_t>(second, 5)) == false);
+    REQUIRE(test.begin()->data().size() == 12);
+}
@@ -0,0 +1,75 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/fanet/rxQueue.hpp"
+
+using namespace FANET;
+
+TEST_CASE("RxQueue", "[RxQueue]")
+{
+    RxQueue<4> queue;
+    uint8_t data[] = {1, 2, 3};
+
+    REQUIRE(queue.empty());
+    REQUIRE(queue.front() == nullptr);
+
+    SECTION("Push and pop in order")
+    {
+        REQUIRE(queue.push(data, -80, 100));
+        REQUIRE(queue.push(etl::span<const uint8_t>(data, 1), -90, 200));
+        REQUIRE(queue.size() == 2);
+
+        auto frame = queue.front();
+        REQUIRE(frame != nullptr);
+        REQUIRE(frame->length == 3);
+        REQUIRE(frame->data[2] == 3);
+        REQUIRE(frame->rssi == -80);
+        REQUIRE(frame->timeMs == 100);
+        queue.pop();
+
+        frame = queue.front();
+        REQUIRE(frame->frame().size() == 1);
+        REQUIRE(frame->rssi == -90);
+        REQUIRE(frame->timeMs == 200);
+        queue.pop();
+        REQUIRE(queue.empty());
+    }
+
+    SECTION("Write into the slot directly")
+    {
+        auto slot = queue.acquire();
+        REQUIRE(slot != nullptr);
+        slot->data[0] = 42;
+        REQUIRE(queue.empty());
+
+        queue.commit(1, -100, 5);
+        REQUIRE(queue.front() == slot);
+        REQUIRE(queue.front()->data[0] == 42);
+    }
+
+    SECTION("Drops frames when full")
+    {
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            REQUIRE(queue.push(data, 0, i));
+        }
+        REQUIRE(queue.push(data, 0, 4) == false);
+        REQUIRE(queue.acquire() == nullptr);
+        REQUIRE(queue.dropped() == 2);
+        REQUIRE(queue.front()->timeMs == 0);
+    }
+
+    SECTION("Wraps around")
+    {
+        for (uint32_t i = 0; i < 10; i++)
+        {
+            REQUIRE(queue.push(data, 0, i));
+            REQUIRE(queue.push(data, 0, i + 100));
+            REQUIRE(queue.front()->timeMs == i);
+            queue.pop();
+            REQUIRE(queue.front()->timeMs == i + 100);
+            queue.pop();
+        }
+        REQUIRE(queue.empty());
+        REQUIRE(queue.dropped() == 0);
+    }
+}
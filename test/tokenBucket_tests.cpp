@@ -0,0 +1,71 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/fanet/tokenBucket.hpp"
+
+using namespace FANET;
+
+TEST_CASE("TokenBucket", "[TokenBucket]")
+{
+    TokenBucket bucket(100, 500);
+    bucket.reset(0);
+    REQUIRE(bucket.available(0) == 500);
+
+    SECTION("Consumes and refills")
+    {
+        REQUIRE(bucket.consume(0, 300) == true);
+        REQUIRE(bucket.available(0) == 200);
+        REQUIRE(bucket.available(1000) == 300);
+        REQUIRE(bucket.available(10000) == 500);
+    }
+
+    SECTION("An older time does not refill")
+    {
+        bucket.consume(2000, 300);
+        REQUIRE(bucket.available(1000) == 200);
+        REQUIRE(bucket.available(2000) == 200);
+        REQUIRE(bucket.available(3000) == 300);
+    }
+
+    SECTION("Time until a frame fits")
+    {
+        REQUIRE(bucket.timeUntil(0, 100) == 0);
+        bucket.consume(0, 450);
+        REQUIRE(bucket.timeUntil(0, 50) == 0);
+        REQUIRE(bucket.timeUntil(0, 100) == 500);
+        REQUIRE(bucket.timeUntil(499, 100) == 1);
+        REQUIRE(bucket.timeUntil(500, 100) == 0);
+    }
+
+    SECTION("Slow rates do not lose tokens to rounding")
+    {
+        bucket.configure(1, 10);
+        bucket.consume(0, 10);
+        for (uint32_t t = 1; t <= 1000; t++)
+        {
+            bucket.available(t);
+        }
+        REQUIRE(bucket.available(1000) == 1);
+    }
+
+    SECTION("Frames larger than the burst are allowed on a full bucket")
+    {
+        bucket.configure(100, 50);
+        REQUIRE(bucket.timeUntil(0, 80) == 0);
+        REQUIRE(bucket.consume(0, 80) == true);
+        REQUIRE(bucket.timeUntil(0, 80) == 500);
+    }
+
+    SECTION("Consuming more than available empties the bucket")
+    {
+        REQUIRE(bucket.consume(0, 400) == true);
+        REQUIRE(bucket.consume(0, 400) == false);
+        REQUIRE(bucket.available(0) == 0);
+    }
+
+    SECTION("Rate is at least 1")
+    {
+        bucket.configure(0, 10);
+        REQUIRE(bucket.rate() == 1);
+        REQUIRE(bucket.burst() == 10);
+    }
+}
@@ -178,7 +178,7 @@ TEST_CASE("TrackingPayload serialize/deserialize altitude", "[single-file]")
     REQUIRE(result == makeVector({0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE2, 0x0C, 0x00, 0x00, 0x00, }));
     
     auto reader = createReader(result);
-    auto received=TrackingPayload::deserialize(reader);
+    auto received=TrackingPayload::deserialize(reader, result.size());
     REQUIRE(received.altitude() == Catch::Approx(5000).margin(0.1));
 }
 
@@ -190,7 +190,7 @@ TEST_CASE("TrackingPayload serialize/deserialize aircraftType", "[single-file]")
     REQUIRE(result == makeVector({0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00 }));
 
     auto reader = createReader(result);
-    auto received=TrackingPayload::deserialize(reader);
+    auto received=TrackingPayload::deserialize(reader, result.size());
     REQUIRE(received.aircraftType() == TrackingPayload::AircraftType::GLIDER);
 }
 
@@ -204,7 +204,7 @@ TEST_CASE("TrackingPayload serialize/deserialize climbRate", "[single-file]")
     REQUIRE(result == makeVector({0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x37, 0x00 }));    
     
     auto reader = createReader(result);
-    auto received=TrackingPayload::deserialize(reader);
+    auto received=TrackingPayload::deserialize(reader, result.size());
     REQUIRE(received.climbRate() == Catch::Approx(5.5).margin(0.1));
 
     payload.climbRate(-5.5f); // -> 0x49
@@ -213,7 +213,7 @@ TEST_CASE("TrackingPayload serialize/deserialize climbRate", "[single-file]")
     REQUIRE(result == makeVector({0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0x00}));
     
     auto reader2 = createReader(result);
-    received=TrackingPayload::deserialize(reader2);
+    received=TrackingPayload::deserialize(reader2, result.size());
     REQUIRE(received.climbRate() == Catch::Approx(-5.5).margin(0.1));
 }
 
@@ -225,7 +225,7 @@ TEST_CASE("TrackingPayload serialize/deserialize groundTrack", "[single-file]")
     REQUIRE(result == makeVector({0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x47,}));  
 
     auto reader = createReader(result);
-    auto received=TrackingPayload::deserialize(reader);
+    auto received=TrackingPayload::deserialize(reader, result.size());
     REQUIRE(received.groundTrack() == Catch::Approx(100).margin(1.4));  
 }
 
@@ -238,7 +238,7 @@ TEST_CASE("TrackingPayload serialize/deserialize speed", "[single-file]")
     REQUIRE(result == makeVector({0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xDE, 0x00, 0x00,}));    
 
     auto reader = createReader(result);
-    auto received=TrackingPayload::deserialize(reader);
+    auto received=TrackingPayload::deserialize(reader, result.size());
     REQUIRE(received.speed() == Catch::Approx(234.f).margin(2));  
 }
 
@@ -250,7 +250,7 @@ TEST_CASE("TrackingPayload serialize/deserialize tracking", "[single-file]")
     REQUIRE(result == makeVector({0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00,}));   
 
     auto reader = createReader(result);
-    auto received=TrackingPayload::deserialize(reader);
+    auto received=TrackingPayload::deserialize(reader, result.size());
     REQUIRE(received.tracking() == true);   
 }
 
@@ -263,7 +263,9 @@ TEST_CASE("TrackingPayload serialize/deserialize turnrate", "[single-file]")
     REQUIRE(result == makeVector({0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3A,}));    
 
     auto reader = createReader(result);
-    auto received=TrackingPayload::deserialize(reader);
+    auto received=TrackingPayload::deserialize(reader, result.size());
+    REQUIRE(received.hasTurnrate() == true);
+    REQUIRE(received.hasQneOffset() == false);
     REQUIRE(received.turnRate() == Catch::Approx(14.4f).margin(0.2));  
 
     payload.turnRate(-14.4f);
@@ -272,7 +274,7 @@ TEST_CASE("TrackingPayload serialize/deserialize turnrate", "[single-file]")
     REQUIRE(result == makeVector({0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46,}));    
 
     auto reader2 = createReader(result);
-    auto received2=TrackingPayload::deserialize(reader2);
+    auto received2=TrackingPayload::deserialize(reader2, result.size());
     REQUIRE(received2.turnRate() == Catch::Approx(-14.4f).margin(0.2));  
 }
 
@@ -280,7 +282,7 @@ TEST_CASE("TrackingPayload serialize/deserialize no turnrate", "[single-file]")
 {
     TrackingPayload payload;
     auto reader = createReader(makeVector({0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }));
-    auto received=TrackingPayload::deserialize(reader);
+    auto received=TrackingPayload::deserialize(reader, 11);
     REQUIRE(received.hasTurnrate() == false);  
 
 }
@@ -295,7 +297,57 @@ TEST_CASE("TrackingPayload serialize/deserialize lat/long", "[single-file]")
     REQUIRE(result == makeVector({0x95, 0x8A, 0x4A, 0x81, 0x7F, 0xEE, 0x00, 0x00, 0x00, 0x00, 0x00, }));    
 
     auto reader = createReader(result);
-    auto received=TrackingPayload::deserialize(reader);
+    auto received=TrackingPayload::deserialize(reader, result.size());
     REQUIRE(received.longitude() == Catch::Approx(-24.6123f).margin(0.1));
     REQUIRE(received.latitude() == Catch::Approx(52.4123f).margin(0.1));
 }
+
+TEST_CASE("TrackingPayload qneOffset ", "[single-file]")
+{
+    TrackingPayload payload;
+    REQUIRE(payload.hasQneOffset() == false);
+
+    payload.qneOffset(-40);
+    REQUIRE(payload.hasQneOffset() == true);
+    REQUIRE(payload.qneOffset() == -40);
+
+    payload.qneOffset(63);
+    REQUIRE(payload.qneOffset() == 63);
+
+    payload.qneOffset(130);
+    REQUIRE(payload.qneOffset() == 132);
+
+    payload.qneOffset(-130);
+    REQUIRE(payload.qneOffset() == -132);
+
+    payload.qneOffset(20);
+    REQUIRE(payload.qneOffset() == 20);
+
+    payload.qneOffset(1000);
+    REQUIRE(payload.qneOffset() == 252);
+}
+
+TEST_CASE("TrackingPayload serialize/deserialize qneOffset", "[single-file]")
+{
+    TrackingPayload payload;
+    payload.qneOffset(-40);
+    auto result = createRadioPacket(payload);
+    // Turn rate is mandatory when the QNE offset is used
+    REQUIRE(result == makeVector({0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x58,}));
+
+    auto reader = createReader(result);
+    auto received=TrackingPayload::deserialize(reader, result.size());
+    REQUIRE(received.hasTurnrate() == true);
+    REQUIRE(received.turnRate() == 0);
+    REQUIRE(received.hasQneOffset() == true);
+    REQUIRE(received.qneOffset() == -40);
+
+    payload.turnRate(14.4f).qneOffset(200);
+    result = createRadioPacket(payload);
+    REQUIRE(result == makeVector({0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3A, 0xB2,}));
+
+    auto reader2 = createReader(result);
+    received=TrackingPayload::deserialize(reader2, result.size());
+    REQUIRE(received.turnRate() == Catch::Approx(14.4f).margin(0.2));
+    REQUIRE(received.qneOffset() == 200);
+}
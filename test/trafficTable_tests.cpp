@@ -0,0 +1,186 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include "../include/fanet/trafficTable.hpp"
+
+using namespace FANET;
+
+TEST_CASE("TrafficTable", "[TrafficTable]")
+{
+    TrafficTable<4> table;
+    auto tracking = TrackingPayload{}.latitude(47.f).longitude(8.f).altitude(1200).speed(36.f).climbRate(1.5f).groundTrack(90.f).aircraftType(TrackingPayload::AircraftType::PARAGLIDER);
+    table.update(Address{0x01, 0x0001}, tracking, 1000);
+
+    SECTION("Stores the decoded state")
+    {
+        auto aircraft = table.find(Address{0x01, 0x0001});
+        REQUIRE(aircraft.has_value());
+        REQUIRE(aircraft->latitude == Catch::Approx(47.f).margin(0.0001));
+        REQUIRE(aircraft->longitude == Catch::Approx(8.f).margin(0.0001));
+        REQUIRE(aircraft->altitude == 1200);
+        REQUIRE(aircraft->speed == Catch::Approx(36.f).margin(0.5));
+        REQUIRE(aircraft->climbRate == Catch::Approx(1.5f).margin(0.1));
+        REQUIRE(aircraft->heading == Catch::Approx(90.f).margin(2));
+        REQUIRE(aircraft->turnRate == 0);
+        REQUIRE(aircraft->ground == false);
+        REQUIRE(aircraft->type == static_cast<uint8_t>(TrackingPayload::AircraftType::PARAGLIDER));
+        REQUIRE(aircraft->lastUpdate == 1000);
+        REQUIRE(table.find(Address{0x01, 0x0002}).has_value() == false);
+    }
+
+    SECTION("Updates an address in place")
+    {
+        table.update(Address{0x01, 0x0001}, tracking.altitude(1300), 2000);
+        REQUIRE(table.size() == 1);
+        REQUIRE(table.find(Address{0x01, 0x0001})->altitude == 1300);
+
+        table.update(Address{0x01, 0x0001}, tracking.turnRate(-10.f), 2500);
+        REQUIRE(table.find(Address{0x01, 0x0001})->turnRate == Catch::Approx(-10.f));
+
+        table.update(Address{0x01, 0x0001}, GroundTrackingPayload{}.latitude(47.f).longitude(8.f).groundType(GroundTrackingPayload::TrackingType::LANDED_WELL), 3000);
+        auto aircraft = table.find(Address{0x01, 0x0001});
+        REQUIRE(aircraft->ground);
+        REQUIRE(aircraft->type == GroundTrackingPayload::TrackingType::LANDED_WELL);
+        REQUIRE(aircraft->altitude == 0);
+    }
+
+    SECTION("Replaces the oldest entry when full")
+    {
+        for (uint16_t i = 2; i <= 5; i++)
+        {
+            table.update(Address{0x01, i}, tracking, 1000 + i);
+        }
+        REQUIRE(table.size() == 4);
+        REQUIRE(table.contains(Address{0x01, 0x0001}) == false);
+        for (uint16_t i = 2; i <= 5; i++)
+        {
+            REQUIRE(table.contains(Address{0x01, i}));
+        }
+    }
+
+    SECTION("Expires old entries")
+    {
+        table.update(Address{0x01, 0x0002}, tracking, 30000);
+        table.update(Address{0x01, 0x0003}, tracking, 2000);
+        table.expire(62500);
+        REQUIRE(table.size() == 1);
+        REQUIRE(table.contains(Address{0x01, 0x0002}));
+        table.expire(29000);
+        REQUIRE(table.contains(Address{0x01, 0x0002}));
+        table.expire(30000 + TRAFFIC_MAX_AGE_MS + 1);
+        REQUIRE(table.empty());
+    }
+
+    SECTION("Sorted by distance")
+    {
+        table.update(Address{0x01, 0x0002}, TrackingPayload{}.latitude(47.1f).longitude(8.f), 1000);
+        table.update(Address{0x01, 0x0003}, TrackingPayload{}.latitude(47.f).longitude(8.01f), 1000);
+        table.update(Address{0x01, 0x0004}, TrackingPayload{}.latitude(46.95f).longitude(8.f), 1000);
+
+        auto order = table.byDistance(47.f, 8.f);
+        REQUIRE(order.size() == 4);
+        REQUIRE(table.at(order[0]).address == Address{0x01, 0x0001});
+        REQUIRE(table.at(order[1]).address == Address{0x01, 0x0003});
+        REQUIRE(table.at(order[2]).address == Address{0x01, 0x0004});
+        REQUIRE(table.at(order[3]).address == Address{0x01, 0x0002});
+        REQUIRE(table.distance(order[1]) == Catch::Approx(758).margin(10));
+        REQUIRE(table.distance(order[3]) == Catch::Approx(11120).margin(20));
+
+        // Removing an entry moves the last one in its slot
+        table.remove(Address{0x01, 0x0003});
+        table.update(Address{0x01, 0x0005}, TrackingPayload{}.latitude(47.f).longitude(7.99f), 1000);
+        order = table.byDistance(47.f, 8.f);
+        REQUIRE(order.size() == 4);
+        REQUIRE(table.at(order[0]).address == Address{0x01, 0x0001});
+        REQUIRE(table.at(order[1]).address == Address{0x01, 0x0005});
+        REQUIRE(table.at(order[3]).address == Address{0x01, 0x0002});
+    }
+}
+
+TEST_CASE("TrafficTable index", "[TrafficTable]")
+{
+    TrafficTable<32> table;
+    auto tracking = TrackingPayload{}.latitude(47.f).longitude(8.f);
+
+    // Fill, remove every other address and refill, the lookup must survive the backward shifts
+    for (uint16_t i = 0; i < 32; i++)
+    {
+        table.update(Address{0x11, i}, tracking, i);
+    }
+    for (uint16_t i = 0; i < 32; i += 2)
+    {
+        table.remove(Address{0x11, i});
+    }
+    REQUIRE(table.size() == 16);
+    for (uint16_t i = 0; i < 32; i++)
+    {
+        REQUIRE(table.contains(Address{0x11, i}) == (i % 2 == 1));
+        if (i % 2 == 1)
+        {
+            REQUIRE(table.find(Address{0x11, i})->lastUpdate == i);
+        }
+    }
+    for (uint16_t i = 100; i < 116; i++)
+    {
+        table.update(Address{0x22, i}, tracking, i);
+    }
+    REQUIRE(table.size() == 32);
+    REQUIRE(table.find(Address{0x22, 115})->lastUpdate == 115);
+    REQUIRE(table.find(Address{0x11, 31})->lastUpdate == 31);
+}
+
+TEST_CASE("TrafficTable predict", "[TrafficTable]")
+{
+    constexpr float METERS_PER_DEGREE = 111195.f;
+    TrafficTable<4> table;
+    float latitude[4];
+    float longitude[4];
+    float altitude[4];
+    auto northM = [&](size_t slot)
+    { return (latitude[slot] - 47.f) * METERS_PER_DEGREE; };
+    auto eastM = [&](size_t slot)
+    { return (longitude[slot] - 8.f) * METERS_PER_DEGREE * cosf(47.f * 0.01745329f); };
+
+    table.update(Address{0x01, 0x0001}, TrackingPayload{}.latitude(47.f).longitude(8.f).altitude(1000).speed(36.f).climbRate(2.f).groundTrack(0.f), 1000);
+    table.update(Address{0x01, 0x0002}, TrackingPayload{}.latitude(47.f).longitude(8.f).altitude(1000).speed(36.f).groundTrack(0.f).turnRate(18.f), 1000);
+    table.update(Address{0x01, 0x0003}, GroundTrackingPayload{}.latitude(47.f).longitude(8.f), 1000);
+
+    SECTION("Straight")
+    {
+        REQUIRE(table.predict(11000, latitude, longitude, altitude) == 3);
+        REQUIRE(northM(0) == Catch::Approx(100.f).margin(1));
+        REQUIRE(eastM(0) == Catch::Approx(0.f).margin(1));
+        REQUIRE(altitude[0] == Catch::Approx(1020.f).margin(0.5));
+
+        REQUIRE(northM(2) == Catch::Approx(0.f).margin(0.1));
+        REQUIRE(eastM(2) == Catch::Approx(0.f).margin(0.1));
+    }
+
+    SECTION("Turning for a quarter turn, then straight")
+    {
+        // 10m/s at 18deg/s, a quarter turn after 5s with a radius of 31.8m
+        table.predict(6000, latitude, longitude, altitude);
+        REQUIRE(northM(1) == Catch::Approx(31.8f).margin(1));
+        REQUIRE(eastM(1) == Catch::Approx(31.8f).margin(1));
+
+        table.predict(3500, latitude, longitude, altitude);
+        REQUIRE(northM(1) == Catch::Approx(31.8f * 0.7071f).margin(1));
+        REQUIRE(eastM(1) == Catch::Approx(31.8f * 0.2929f).margin(1));
+
+        table.predict(11000, latitude, longitude, altitude);
+        REQUIRE(northM(1) == Catch::Approx(31.8f).margin(1));
+        REQUIRE(eastM(1) == Catch::Approx(81.8f).margin(1));
+    }
+
+    SECTION("Limited in time and output size")
+    {
+        table.predict(1000 + DEAD_RECKONING_MAX_MS + 10000, latitude, longitude, altitude);
+        REQUIRE(northM(0) == Catch::Approx(200.f).margin(2));
+
+        // Reports newer than the time are not moved back
+        table.predict(0, latitude, longitude, altitude);
+        REQUIRE(northM(0) == Catch::Approx(0.f).margin(0.1));
+
+        REQUIRE(table.predict(11000, etl::span<float>(latitude, 2), longitude, altitude) == 2);
+    }
+}
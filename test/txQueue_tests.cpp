@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thread>
+#include <vector>
+
+#include "../include/fanet/txQueue.hpp"
+
+using namespace FANET;
+
+TEST_CASE("TxQueue", "[TxQueue]")
+{
+    TxQueue<4> queue;
+    uint8_t data[] = {1, 2, 3};
+
+    REQUIRE(queue.empty());
+    REQUIRE(queue.front() == nullptr);
+
+    SECTION("Push and pop in order")
+    {
+        REQUIRE(queue.push(data, 10, 0));
+        REQUIRE(queue.push(etl::span<const uint8_t>(data, 1), 11, 3));
+        REQUIRE(queue.size() == 2);
+
+        auto submission = queue.front();
+        REQUIRE(submission != nullptr);
+        REQUIRE(submission->frame().size() == 3);
+        REQUIRE(submission->data[2] == 3);
+        REQUIRE(submission->id == 10);
+        REQUIRE(submission->numTx == 0);
+        queue.pop();
+
+        submission = queue.front();
+        REQUIRE(submission->frame().size() == 1);
+        REQUIRE(submission->id == 11);
+        REQUIRE(submission->numTx == 3);
+        queue.pop();
+        REQUIRE(queue.empty());
+    }
+
+    SECTION("Drops frames when full")
+    {
+        for (uint16_t i = 0; i < 4; i++)
+        {
+            REQUIRE(queue.push(data, i, 0));
+        }
+        REQUIRE(queue.push(data, 4, 0) == false);
+        REQUIRE(queue.dropped() == 1);
+
+        queue.pop();
+        REQUIRE(queue.push(data, 4, 0));
+        REQUIRE(queue.front()->id == 1);
+    }
+
+    SECTION("Wraps around")
+    {
+        for (uint16_t i = 0; i < 10; i++)
+        {
+            REQUIRE(queue.push(data, i, 0));
+            REQUIRE(queue.front()->id == i);
+            queue.pop();
+        }
+        REQUIRE(queue.empty());
+    }
+}
+
+// Run with -DENABLE_TSAN=ON to check the queue with ThreadSanitizer
+TEST_CASE("TxQueue multiple producers", "[TxQueue]")
+{
+    static constexpr uint16_t PRODUCERS = 4;
+    static constexpr uint16_t FRAMES = 5000;
+    TxQueue<8> queue;
+
+    std::vector<std::thread> producers;
+    for (uint16_t p = 0; p < PRODUCERS; p++)
+    {
+        producers.emplace_back([&queue, p]()
+                               {
+            for (uint16_t i = 0; i < FRAMES;)
+            {
+                uint8_t data[] = {static_cast<uint8_t>(p), static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8)};
+                if (queue.push(data, p * FRAMES + i, p))
+                {
+                    i++;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            } });
+    }
+
+    // Frames of each producer arrive in order, each frame exactly once and unchanged
+    uint16_t next[PRODUCERS] = {};
+    uint32_t received = 0;
+    while (received < PRODUCERS * FRAMES)
+    {
+        auto submission = queue.front();
+        if (submission == nullptr)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        auto p = submission->numTx;
+        REQUIRE(p < PRODUCERS);
+        REQUIRE(submission->length == 3);
+        REQUIRE(submission->data[0] == p);
+        REQUIRE(submission->id == p * FRAMES + next[p]);
+        REQUIRE((submission->data[1] | (submission->data[2] << 8)) == next[p]);
+        next[p]++;
+        received++;
+        queue.pop();
+    }
+
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+    REQUIRE(queue.empty());
+}
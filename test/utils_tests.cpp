@@ -133,6 +133,45 @@ TEST_CASE("toScaled altitude", "[Utils]")
     REQUIRE(result.value == altitude_Origional(5000.f));
 }
 
+TEST_CASE("LoraAirtime", "[Utils]")
+{
+    SECTION("Integer version matches the original for all modulations")
+    {
+        for (int sf = 7; sf <= 12; sf++)
+        {
+            for (int bw : {125, 250, 500})
+            {
+                for (int cr = 1; cr <= 4; cr++)
+                {
+                    for (int size = 0; size < 256; size++)
+                    {
+                        REQUIRE(LoraAirtime(size, sf, bw, cr) == LoraAirtime_Origional(size, sf, bw, cr));
+                        REQUIRE(LoraAirtime(size, sf, bw, cr, 2, false) == LoraAirtime_Origional(size, sf, bw, cr, 2, false));
+                    }
+                }
+            }
+        }
+    }
+
+    SECTION("Table matches the calculation")
+    {
+        for (int cr = 1; cr <= 4; cr++)
+        {
+            for (int size = 0; size < 256; size++)
+            {
+                REQUIRE(FanetAirtime::get(size, cr) == LoraAirtime_Origional(size, 7, 250, cr));
+            }
+        }
+    }
+
+    SECTION("Evaluated at compile time")
+    {
+        static_assert(LoraAirtime(20, 7, 250, 1) == 28);
+        static_assert(FanetAirtime::get(20, 4) == LoraAirtime(20, 7, 250, 4));
+        REQUIRE(FanetAirtime::get(255, 4) == 313);
+    }
+}
+
 TEST_CASE("Calculate Airtime", "[Utils]")
 {
     uint32_t MINUTE = 1000 * 60;
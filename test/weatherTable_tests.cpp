@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include "../include/fanet/weatherTable.hpp"
+
+using namespace FANET;
+
+TEST_CASE("WeatherTable", "[WeatherTable]")
+{
+    // Window of 60s in buckets of 10s
+    WeatherTable<2> table(60000);
+    const Address station{0x01, 0x0001};
+
+    table.update(station, ServicePayload{}.temperature(10.f).windSpeed(20.f).windGust(30.f), 1000);
+    table.update(station, ServicePayload{}.temperature(14.f).windSpeed(10.f).windGust(40.f), 15000);
+    table.update(station, ServicePayload{}.temperature(12.f).humidity(50.f), 25000);
+
+    SECTION("Latest report")
+    {
+        auto latest = table.latest(station);
+        REQUIRE(latest != nullptr);
+        REQUIRE(latest->temperature() == 12.f);
+        REQUIRE(latest->hasWind() == false);
+        REQUIRE(table.stations()[0].lastUpdate == 25000);
+        REQUIRE(table.latest(Address{0x01, 0x0002}) == nullptr);
+    }
+
+    SECTION("Statistics over the window")
+    {
+        auto temperature = table.statistics(station, WeatherValue::TEMPERATURE, 30000);
+        REQUIRE(temperature.count == 3);
+        REQUIRE(temperature.minimum == 10.f);
+        REQUIRE(temperature.maximum == 14.f);
+        REQUIRE(temperature.average == Catch::Approx(12.f));
+
+        auto gust = table.statistics(station, WeatherValue::WIND_GUST, 30000);
+        REQUIRE(gust.count == 2);
+        REQUIRE(gust.maximum == Catch::Approx(40.f).margin(1));
+
+        REQUIRE(table.statistics(station, WeatherValue::HUMIDITY, 30000).count == 1);
+        REQUIRE(table.statistics(station, WeatherValue::BAROMETRIC, 30000).count == 0);
+        REQUIRE(table.statistics(Address{0x01, 0x0002}, WeatherValue::TEMPERATURE, 30000).count == 0);
+    }
+
+    SECTION("Old buckets leave the window")
+    {
+        // The bucket of 0-10s is out of the window at 60s
+        auto temperature = table.statistics(station, WeatherValue::TEMPERATURE, 60000);
+        REQUIRE(temperature.count == 2);
+        REQUIRE(temperature.minimum == 12.f);
+
+        // A report in the same bucket of the next round replaces it
+        table.update(station, ServicePayload{}.temperature(20.f), 75000);
+        temperature = table.statistics(station, WeatherValue::TEMPERATURE, 75000);
+        REQUIRE(temperature.count == 2);
+        REQUIRE(temperature.average == Catch::Approx(16.f));
+
+        REQUIRE(table.statistics(station, WeatherValue::TEMPERATURE, 200000).count == 0);
+    }
+
+    SECTION("Reports after the query time are not counted")
+    {
+        auto temperature = table.statistics(station, WeatherValue::TEMPERATURE, 12000);
+        REQUIRE(temperature.count == 2);
+        REQUIRE(temperature.maximum == 14.f);
+        REQUIRE(table.statistics(station, WeatherValue::HUMIDITY, 12000).count == 0);
+    }
+
+    SECTION("Ignores services without weather")
+    {
+        table.update(Address{0x01, 0x0002}, ServicePayload{}.setGateway(true), 30000);
+        REQUIRE(table.size() == 1);
+    }
+
+    SECTION("Removes the station that reported the longest time ago")
+    {
+        table.update(Address{0x01, 0x0002}, ServicePayload{}.temperature(5.f), 30000);
+        table.update(Address{0x01, 0x0003}, ServicePayload{}.temperature(6.f), 31000);
+        REQUIRE(table.size() == 2);
+        REQUIRE(table.latest(station) == nullptr);
+        REQUIRE(table.latest(Address{0x01, 0x0003})->temperature() == 6.f);
+    }
+
+    SECTION("Changing the window clears the statistics")
+    {
+        table.window(600000);
+        REQUIRE(table.window() == 600000);
+        REQUIRE(table.statistics(station, WeatherValue::TEMPERATURE, 30000).count == 0);
+        REQUIRE(table.latest(station) != nullptr);
+    }
+}
@@ -1,6 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "../include/fanet/zone.hpp"
+#include "../include/fanet/zoneTracker.hpp"
 
 using namespace FANET;
 
@@ -19,3 +20,185 @@ TEST_CASE("Test Zone", "[Zone]") {
         REQUIRE(zone.findZone(91, 0).name == "UNK");
     }
 }
+
+TEST_CASE("Zone grid", "[Zone]")
+{
+    Zone grid;
+    Zone linear(DEFAULT_ZONES);
+    REQUIRE(linear.grid == nullptr);
+
+    SECTION("Same result as the linear search for every whole degree")
+    {
+        for (int16_t lat = -95; lat <= 95; lat++)
+        {
+            for (int16_t lon = -185; lon <= 185; lon++)
+            {
+                REQUIRE(&grid.findZone(lat, lon) == &linear.findZone(lat, lon));
+            }
+        }
+    }
+
+    SECTION("Same result for fractional degrees near borders")
+    {
+        REQUIRE(&grid.findZone(-10.5f, 150.0f) == &linear.findZone(-10.5f, 150.0f));
+        REQUIRE(grid.findZone(-10.5f, 150.0f).name == "AU920");
+        REQUIRE(grid.findZone(-9.5f, 150.0f).name == "EU868");
+        REQUIRE(grid.findZone(36.9f, 127.5f).name == "KR923");
+    }
+
+    SECTION("Cells inside a single zone are resolved by the grid")
+    {
+        static_assert(Zone::DEFAULT_GRID.lookup(52, 4) == 6);
+        static_assert(Zone::DEFAULT_GRID.lookup(-30, 140) == 1);
+        REQUIRE(Zone::DEFAULT_GRID.lookup(34, 130) == ZoneGrid::MIXED);
+        REQUIRE(Zone::DEFAULT_GRID.lookup(91, 0) == ZoneGrid::MIXED);
+    }
+}
+
+static constexpr etl::array<ZoneRegion, 3> CUSTOM_ZONES = {
+    ZoneRegion{"NORTH", {868200, 14, 250}, 90, 1, 180, -180},
+    ZoneRegion{"SOUTH", {920800, 15, 500}, -1, -90, 180, -180},
+    DEFAULT_ZONE};
+static constexpr auto CUSTOM_GRID = ZoneGrid::build(CUSTOM_ZONES);
+
+TEST_CASE("Zone grid with custom zones", "[Zone]")
+{
+    Zone zone(CUSTOM_ZONES, &CUSTOM_GRID);
+
+    REQUIRE(zone.findZone(45.0f, 7.0f).name == "NORTH");
+    REQUIRE(zone.findZone(-45.0f, 7.0f).name == "SOUTH");
+    REQUIRE(zone.findZone(0.5f, 7.0f).name == "UNK");
+    REQUIRE(CUSTOM_GRID.lookup(45, 7) == 0);
+    REQUIRE(CUSTOM_GRID.lookup(0, 7) == ZoneGrid::MIXED);
+}
+
+class TestZoneListener : public ZoneTracker::Listener
+{
+public:
+    int changes = 0;
+    etl::string_view last;
+
+    void zoneChanged(const ZoneRegion &zone) override
+    {
+        changes++;
+        last = zone.name;
+    }
+};
+
+TEST_CASE("ZoneTracker", "[Zone]")
+{
+    Zone zone;
+    TestZoneListener listener;
+    ZoneTracker tracker(zone, &listener);
+    REQUIRE(tracker.current().name == "UNK");
+
+    REQUIRE(tracker.update(-5.0f, 150.0f) == true);
+    REQUIRE(tracker.current().name == "EU868");
+    REQUIRE(listener.changes == 1);
+    REQUIRE(listener.last == "EU868");
+
+    SECTION("No change while moving inside the zone")
+    {
+        REQUIRE(tracker.update(-5.5f, 150.5f) == false);
+        REQUIRE(tracker.update(-8.0f, 153.0f) == false);
+        REQUIRE(listener.changes == 1);
+    }
+
+    SECTION("Hysteresis at the border")
+    {
+        REQUIRE(tracker.update(-10.05f, 150.0f) == false);
+        REQUIRE(tracker.current().name == "EU868");
+
+        REQUIRE(tracker.update(-10.2f, 150.0f) == true);
+        REQUIRE(tracker.current().name == "AU920");
+        REQUIRE(listener.last == "AU920");
+
+        REQUIRE(tracker.update(-9.95f, 150.0f) == false);
+        REQUIRE(tracker.current().name == "AU920");
+
+        REQUIRE(tracker.update(-9.8f, 150.0f) == true);
+        REQUIRE(tracker.current().name == "EU868");
+        REQUIRE(listener.changes == 3);
+    }
+
+    SECTION("Without hysteresis the zone follows findZone")
+    {
+        ZoneTracker direct(zone, nullptr, 0.0f);
+        REQUIRE(direct.update(-9.95f, 150.0f) == true);
+        REQUIRE(direct.update(-10.05f, 150.0f) == true);
+        REQUIRE(direct.current().name == "AU920");
+    }
+
+    SECTION("Reset raises a new change")
+    {
+        tracker.reset();
+        REQUIRE(tracker.update(-5.0f, 150.0f) == true);
+        REQUIRE(listener.changes == 2);
+    }
+}
+
+// Triangle with the corners 10N 10E, 10N 30E and 30N 10E
+static constexpr ZoneVertex TRIANGLE[] = {{1000, 1000}, {1000, 3000}, {3000, 1000}};
+static constexpr etl::array<ZoneRegion, 3> POLYGON_ZONES = {
+    ZoneRegion{"TRI", {868200, 14, 250}, 30, 10, 30, 10, TRIANGLE},
+    ZoneRegion{"REST", {920800, 15, 500}, 90, -90, 180, -180},
+    DEFAULT_ZONE};
+static constexpr auto POLYGON_GRID = ZoneGrid::build(POLYGON_ZONES);
+
+TEST_CASE("Zone polygon", "[Zone]")
+{
+    SECTION("Point in polygon")
+    {
+        static_assert(ZonePolygon::contains(TRIANGLE, 1500, 1500));
+        static_assert(!ZonePolygon::contains(TRIANGLE, 2500, 2500));
+        REQUIRE(ZonePolygon::contains(TRIANGLE, 1001, 2998) == true);
+        REQUIRE(ZonePolygon::contains(TRIANGLE, 999, 1500) == false);
+        REQUIRE(ZonePolygon::contains(TRIANGLE, 2001, 2001) == false);
+        REQUIRE(ZonePolygon::contains(TRIANGLE, 1999, 1999) == true);
+    }
+
+    SECTION("Rectangle coverage")
+    {
+        REQUIRE(ZonePolygon::covers(TRIANGLE, 1100, 1500, 1100, 1500) == true);
+        REQUIRE(ZonePolygon::covers(TRIANGLE, 1500, 2500, 1500, 2500) == false);
+        REQUIRE(ZonePolygon::disjoint(TRIANGLE, 2600, 2900, 2600, 2900) == true);
+        REQUIRE(ZonePolygon::disjoint(TRIANGLE, 1500, 2500, 1500, 2500) == false);
+        // Polygon completely inside the rectangle
+        REQUIRE(ZonePolygon::disjoint(TRIANGLE, 0, 4000, 0, 4000) == false);
+    }
+
+    SECTION("findZone uses the polygon within the box")
+    {
+        Zone linear(POLYGON_ZONES);
+        REQUIRE(linear.findZone(15.5f, 15.5f).name == "TRI");
+        REQUIRE(linear.findZone(25.5f, 25.5f).name == "REST");
+        REQUIRE(linear.findZone(19.9f, 19.9f).name == "TRI");
+        REQUIRE(linear.findZone(20.1f, 20.1f).name == "REST");
+    }
+
+    SECTION("Grid gives the same result as the linear search")
+    {
+        Zone grid(POLYGON_ZONES, &POLYGON_GRID);
+        Zone linear(POLYGON_ZONES);
+        for (float lat = 5.f; lat <= 35.f; lat += 0.25f)
+        {
+            for (float lon = 5.f; lon <= 35.f; lon += 0.25f)
+            {
+                REQUIRE(&grid.findZone(lat, lon) == &linear.findZone(lat, lon));
+            }
+        }
+        REQUIRE(POLYGON_GRID.lookup(11, 11) == ZoneGrid::MIXED);
+        REQUIRE(POLYGON_GRID.lookup(-50, 100) == 1);
+    }
+
+    SECTION("Tracker does not cache whole degree cells with polygons")
+    {
+        Zone grid(POLYGON_ZONES, &POLYGON_GRID);
+        ZoneTracker tracker(grid, nullptr, 0.0f);
+        REQUIRE(tracker.update(19.9f, 19.9f) == true);
+        REQUIRE(tracker.current().name == "TRI");
+        REQUIRE(tracker.update(19.95f, 19.95f) == false);
+        REQUIRE(tracker.update(19.99f, 20.2f) == true);
+        REQUIRE(tracker.current().name == "REST");
+    }
+}